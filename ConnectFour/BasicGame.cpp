@@ -0,0 +1,87 @@
+#include "BasicGame.hpp"
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+BasicGame<Rows, Cols, K>::BasicGame(){
+	playerOne = 0;
+	playerTwo = 0;
+	gameStatus = Game::GS_INVALID;
+	turn = 0;
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+void BasicGame<Rows, Cols, K>::setPlayerOne(Player* player){
+	// The grid is always there, so the game is ready once both players are
+	if(player != 0 && player != playerTwo){
+		playerOne = player;
+		if(playerTwo != 0){
+			gameStatus = Game::GS_IN_PROGRESS;
+		}
+	}
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+void BasicGame<Rows, Cols, K>::setPlayerTwo(Player* player){
+	if(player != 0 && player != playerOne){
+		playerTwo = player;
+		if(playerOne != 0){
+			gameStatus = Game::GS_IN_PROGRESS;
+		}
+	}
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+void BasicGame<Rows, Cols, K>::restart(){
+	if(gameStatus != Game::GS_INVALID){
+		board.reset();
+		playerOne->resetScore();
+		playerTwo->resetScore();
+		gameStatus = Game::GS_IN_PROGRESS;
+		turn = 0;
+	}
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+const Player* BasicGame<Rows, Cols, K>::winner() const{
+	// Same as Game: a game that ends on a full grid is reported as a draw, otherwise the last player to move won
+	if(gameStatus == Game::GS_COMPLETE){
+		if(turn == Rows * Cols){
+			return 0;
+		}
+		return turn % 2 == 0 ? playerTwo : playerOne;
+	}
+	return 0;
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+const Player* BasicGame<Rows, Cols, K>::nextPlayer() const{
+	if(gameStatus == Game::GS_IN_PROGRESS){
+		return turn % 2 == 0 ? playerOne : playerTwo;
+	}
+	return 0;
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+bool BasicGame<Rows, Cols, K>::playNextTurn(unsigned int column){
+	if(gameStatus != Game::GS_IN_PROGRESS){
+		return false;
+	}
+	Player* player = turn % 2 == 0 ? playerOne : playerTwo;
+	Grid::Cell disc = turn % 2 == 0 ? Grid::GC_PLAYER_ONE : Grid::GC_PLAYER_TWO;
+	if(!board.insertDisc(column, disc)){
+		return false;
+	}
+	if(board.connectsFour(Rows - board.columnHeight(column), column, disc)){
+		gameStatus = Game::GS_COMPLETE;
+		player->increaseScore();
+		player->increaseWins();
+	}
+	turn++;
+	if(turn == Rows * Cols){
+		gameStatus = Game::GS_COMPLETE;
+	}
+	return true;
+}
+
+// The supported sizes
+template class BasicGame<6, 7>;
+template class BasicGame<7, 8>;
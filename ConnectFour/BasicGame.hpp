@@ -0,0 +1,78 @@
+#ifndef BASICGAME_HPP
+#define BASICGAME_HPP
+
+#include "BasicGrid.hpp"
+#include "Game.hpp"
+#include "Player.hpp"
+
+/*
+BasicGame plays a standard game of Connect Four (K in a row wins) on a BasicGrid, whose size is fixed at compile time.
+It follows exactly the same rules as a Game on a Grid of the same size and has the same interface, but it owns its grid
+directly rather than through a pointer, none of its methods are virtual, and it can be copied, so it suits hot loops
+such as simulations and searches that only play standard sizes. Use Game (or SuperGame) for any other size or rules.
+
+The game is GS_INVALID until both players are assigned; the grid is always there. As with a Game, the players are not
+owned by the BasicGame.
+
+Like BasicGrid, only the sizes explicitly instantiated in BasicGame.cpp (6x7 and 7x8 with K = 4) can be used.
+*/
+template <unsigned int Rows, unsigned int Cols, unsigned int K = 4>
+class BasicGame {
+public:
+    typedef BasicGrid<Rows, Cols, K> GridType;
+
+    /*
+    Create a new game with an empty grid and no players.
+    */
+    BasicGame();
+
+    /*
+    Set the specified player as Player One. See `Game::setPlayerOne`.
+    */
+    void setPlayerOne(Player* player);
+
+    /*
+    Set the specified player as Player Two. See `Game::setPlayerTwo`.
+    */
+    void setPlayerTwo(Player* player);
+
+    /*
+    Restart the game, clearing the grid and resetting the scores of both players. See `Game::restart`.
+    */
+    void restart();
+
+    /*
+    Get the current game status.
+    */
+    Game::Status status() const { return gameStatus; }
+
+    /*
+    If the game is complete, return the winning player, or a null pointer (0) for a draw. See `Game::winner`.
+    */
+    const Player* winner() const;
+
+    /*
+    Get the player who moves next, or a null pointer (0) if the game is not in progress.
+    */
+    const Player* nextPlayer() const;
+
+    /*
+    Get the grid the game is played on.
+    */
+    const GridType& grid() const { return board; }
+
+    /*
+    Execute the turn of the next player by inserting a disc into the indicated column. Returns `false`, without changing
+    anything, if the game is not in progress or the column can't take another disc. See `Game::playNextTurn`.
+    */
+    bool playNextTurn(unsigned int column);
+
+private:
+    GridType board;
+    Player* playerOne;
+    Player* playerTwo;
+    Game::Status gameStatus;
+    unsigned int turn;
+};
+
+#endif /* end of include guard: BASICGAME_HPP */
@@ -0,0 +1,162 @@
+#include "BasicGrid.hpp"
+
+// Shift right, giving 0 rather than undefined behaviour once every bit has been shifted out
+template <typename Board>
+static inline Board shiftDown(Board bits, unsigned int amount){
+	return amount < sizeof(Board) * 8 ? bits >> amount : 0;
+}
+
+// Mark the lowest bit of every run of K consecutive set bits, each Step apart. The run length covered doubles while that
+// stays within K, then one overlapping shift covers the rest; every shift is a constant.
+template <typename Board, unsigned int K, unsigned int Step>
+static inline Board runStarts(Board bits){
+	Board runs = bits;
+	unsigned int length = 1;
+	while(length * 2 <= K){
+		runs &= shiftDown(runs, length * Step);
+		length *= 2;
+	}
+	if(length < K){
+		runs &= shiftDown(runs, (K - length) * Step);
+	}
+	return runs;
+}
+
+// Return true if a run of K set bits, each Step apart, passes through the single bit `cell`
+template <typename Board, unsigned int K, unsigned int Step>
+static inline bool runThrough(Board bits, Board cell){
+	// such a run must start at most K - 1 steps before the cell
+	Board starts = 0;
+	for(unsigned int j = 0; j < K; j++){
+		starts |= shiftDown(cell, j * Step);
+	}
+	return (runStarts<Board, K, Step>(bits) & starts) != 0;
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+BasicGrid<Rows, Cols, K>::BasicGrid(){
+	reset();
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+void BasicGrid<Rows, Cols, K>::reset(){
+	boards[0] = 0;
+	boards[1] = 0;
+	for(unsigned int i = 0; i < Cols; i++){
+		heights[i] = 0;
+	}
+	filled = 0;
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+bool BasicGrid<Rows, Cols, K>::insertDisc(unsigned int column, Cell disc){
+	if(disc == Grid::GC_EMPTY || column >= Cols || heights[column] == Rows){
+		return false;
+	}
+	// the disc lands on top of the discs already in the column
+	Board mask = (Board)1 << (column * STRIDE + heights[column]);
+	if(((boards[0] | boards[1]) & mask) == 0){
+		heights[column]++;
+		filled++;
+	}
+	boards[0] &= ~mask;
+	boards[1] &= ~mask;
+	boards[disc == Grid::GC_PLAYER_ONE ? 0 : 1] |= mask;
+	return true;
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+typename BasicGrid<Rows, Cols, K>::Cell BasicGrid<Rows, Cols, K>::cellAt(unsigned int row, unsigned int column) const{
+	if(row >= Rows || column >= Cols){
+		return Grid::GC_EMPTY;
+	}
+	Board mask = (Board)1 << bitIndex(row, column);
+	if(boards[0] & mask){
+		return Grid::GC_PLAYER_ONE;
+	} else if(boards[1] & mask){
+		return Grid::GC_PLAYER_TWO;
+	}
+	return Grid::GC_EMPTY;
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+void BasicGrid<Rows, Cols, K>::makeEmptyCell(int x, int y){
+	if(x < 0 || y < 0 || (unsigned int)x >= Cols || (unsigned int)y >= Rows){
+		return;
+	}
+	Board mask = (Board)1 << bitIndex(y, x);
+	if((boards[0] | boards[1]) & mask){
+		heights[x]--;
+		filled--;
+		boards[0] &= ~mask;
+		boards[1] &= ~mask;
+	}
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+void BasicGrid<Rows, Cols, K>::fallDown(){
+	std::vector<std::pair<unsigned int, unsigned int> > moved;
+	fallDown(moved);
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+void BasicGrid<Rows, Cols, K>::fallDown(std::vector<std::pair<unsigned int, unsigned int> >& moved){
+	const Board column = ((Board)1 << Rows) - 1;
+	for(unsigned int l = 0; l < Cols; l++){
+		// Leave columns without gaps alone, and gather the discs of the rest down past the gaps in one go
+		unsigned int base = l * STRIDE;
+		Board one = (boards[0] >> base) & column;
+		Board two = (boards[1] >> base) & column;
+		Board occupied = one | two;
+		if(occupied == ((Board)1 << heights[l]) - 1){
+			continue;
+		}
+		boards[0] = (boards[0] & ~(column << base)) | ((Board)Grid::gatherBits(one, occupied) << base);
+		boards[1] = (boards[1] & ~(column << base)) | ((Board)Grid::gatherBits(two, occupied) << base);
+		// Every disc above the lowest gap has moved
+		unsigned int free = 0;
+		while((occupied >> free) & 1){
+			free++;
+		}
+		for(; free < heights[l]; free++){
+			moved.push_back(std::make_pair(Rows - 1 - free, l));
+		}
+	}
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+bool BasicGrid<Rows, Cols, K>::connectsFour(unsigned int row, unsigned int column, Cell disc) const{
+	if(disc == Grid::GC_EMPTY || row >= Rows || column >= Cols){
+		return false;
+	}
+	Board bits = discs(disc);
+	Board cell = (Board)1 << bitIndex(row, column);
+	// vertical, horizontal and both diagonals
+	return runThrough<Board, K, 1>(bits, cell) || runThrough<Board, K, STRIDE>(bits, cell) ||
+		   runThrough<Board, K, STRIDE - 1>(bits, cell) || runThrough<Board, K, STRIDE + 1>(bits, cell);
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+bool BasicGrid<Rows, Cols, K>::hasWin(Cell disc) const{
+	Board bits = discs(disc);
+	return (runStarts<Board, K, 1>(bits) | runStarts<Board, K, STRIDE>(bits) | runStarts<Board, K, STRIDE - 1>(bits) |
+			runStarts<Board, K, STRIDE + 1>(bits)) != 0;
+}
+
+template <unsigned int Rows, unsigned int Cols, unsigned int K>
+void BasicGrid<Rows, Cols, K>::copyTo(Grid& grid) const{
+	// Drop the discs of each column in from the bottom; any gaps are closed up on the way
+	grid.reset();
+	for(unsigned int column = 0; column < Cols; column++){
+		for(unsigned int row = Rows; row-- > 0;){
+			Cell cell = cellAt(row, column);
+			if(cell != Grid::GC_EMPTY){
+				grid.insertDisc(column, cell);
+			}
+		}
+	}
+}
+
+// The supported sizes
+template class BasicGrid<6, 7>;
+template class BasicGrid<7, 8>;
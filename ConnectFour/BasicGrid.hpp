@@ -0,0 +1,146 @@
+#ifndef BASICGRID_HPP
+#define BASICGRID_HPP
+
+#include "Grid.hpp"
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+BasicGrid is a Grid whose dimensions, and the number of discs in a row needed to win (K), are fixed at compile time. It
+has the same interface and behaves exactly the same way as a Grid of the same size, but every bound and loop count is a
+constant, so the compiler can unroll the win checks completely, and the whole board is held inline in a single word per
+player: a 32-bit word when it fits, a 64-bit word otherwise. A BasicGrid never allocates.
+
+The cells use the same column-major bitboard layout as a Grid, with (Rows + 1) bits per column and an always-empty bit on
+top of each column. Only boards with (Rows + 1) * Cols <= 64 are supported; larger boards should use the runtime Grid.
+
+The member functions are compiled once for each supported size, so only the sizes explicitly instantiated in
+BasicGrid.cpp (6x7 and 7x8, each with K = 4) can be used. Add another instantiation there to support a new size.
+*/
+template <unsigned int Rows, unsigned int Cols, unsigned int K = 4>
+class BasicGrid {
+public:
+    static_assert(Rows >= 4 && Cols >= 4, "a grid is at least 4x4");
+    static_assert((Rows + 1) * Cols <= 64, "the grid must fit in a single 64-bit word, use Grid for larger grids");
+    static_assert(K >= 2 && (K <= Rows || K <= Cols), "the win length must fit on the grid");
+
+    typedef Grid::Cell Cell;
+
+    /*
+    The bitboard word type: the smallest unsigned integer holding (Rows + 1) * Cols bits.
+    */
+    typedef typename std::conditional<(Rows + 1) * Cols <= 32, uint32_t, uint64_t>::type Board;
+
+    static const unsigned int ROWS = Rows;
+    static const unsigned int COLUMNS = Cols;
+    static const unsigned int WIN_LENGTH = K;
+    static const unsigned int STRIDE = Rows + 1;
+
+    /*
+    Create an empty grid.
+    */
+    BasicGrid();
+
+    /*
+    Insert a disc at the top of the specified column. Returns `false`, without changing the grid, if the disc is
+    GC_EMPTY, the column is full or the column is out of bounds. See `Grid::insertDisc`.
+    */
+    bool insertDisc(unsigned int column, Cell disc);
+
+    /*
+    Return the value of the cell at the specified row and column (row 0 being the top of the grid), or GC_EMPTY for
+    cells outside the grid.
+    */
+    Cell cellAt(unsigned int row, unsigned int column) const;
+
+    /*
+    Empty every cell of the grid.
+    */
+    void reset();
+
+    /*
+    Return the number of rows in the grid.
+    */
+    unsigned int rowCount() const { return Rows; }
+
+    /*
+    Return the number of columns in the grid.
+    */
+    unsigned int columnCount() const { return Cols; }
+
+    /*
+    Return the number of discs in the specified column, or 0 for a column outside the grid.
+    */
+    unsigned int columnHeight(unsigned int column) const {
+        return column < Cols ? heights[column] : 0;
+    }
+
+    /*
+    Return `true` if the specified column can't take another disc (including columns outside the grid).
+    */
+    bool isColumnFull(unsigned int column) const {
+        return column >= Cols || heights[column] == Rows;
+    }
+
+    /*
+    Return the total number of discs currently in the grid.
+    */
+    unsigned int discCount() const { return filled; }
+
+    /*
+    Empty the cell at column x and row y.
+    */
+    void makeEmptyCell(int x, int y);
+
+    /*
+    Drop every disc down past any empty cells below it.
+    */
+    void fallDown();
+
+    /*
+    Same as above, also appending the (row, column) each disc that moved has landed on to `moved`.
+    */
+    void fallDown(std::vector<std::pair<unsigned int, unsigned int> >& moved);
+
+    /*
+    Return `true` if every cell of the grid holds a disc.
+    */
+    bool noMoreMoves() const { return filled == Rows * Cols; }
+
+    /*
+    Return `true` if the discs of the given player form K in a row (horizontally, vertically or diagonally) through the
+    cell at (row, column). Returns `false` for GC_EMPTY or a cell outside the grid.
+    */
+    bool connectsFour(unsigned int row, unsigned int column, Cell disc) const;
+
+    /*
+    Return `true` if the discs of the given player form K in a row anywhere on the grid.
+    */
+    bool hasWin(Cell disc) const;
+
+    /*
+    Return the bitboard of the given player's discs.
+    */
+    Board discs(Cell disc) const {
+        return disc == Grid::GC_PLAYER_ONE ? boards[0] : disc == Grid::GC_PLAYER_TWO ? boards[1] : 0;
+    }
+
+    /*
+    Copy the discs of this grid into a runtime Grid of the same size, replacing whatever it held.
+    */
+    void copyTo(Grid& grid) const;
+
+private:
+    // Index of the bit representing the cell at (row, column)
+    static unsigned int bitIndex(unsigned int row, unsigned int column) {
+        return column * STRIDE + (Rows - 1 - row);
+    }
+
+    Board boards[2];    // player one's discs, then player two's
+    unsigned char heights[Cols];
+    unsigned char filled;
+};
+
+#endif /* end of include guard: BASICGRID_HPP */
@@ -0,0 +1,305 @@
+#include "EndgameDatabase.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <typeinfo>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char MAGIC[4] = { 'C', '4', 'E', 'D' };
+static const uint32_t VERSION = 1;
+
+// Entries per bucket the buckets are sized for, at most
+static const uint64_t BUCKET_ENTRIES = 8;
+
+struct DatabaseHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t rows;
+	uint32_t columns;
+	uint32_t bucketBits;
+	uint32_t keyBytes;
+	uint64_t count;
+};
+
+// Bytes needed to hold any key of the given grid size
+static unsigned int keyBytesFor(unsigned int rows, unsigned int columns){
+	return ((rows + 1) * columns + 7) / 8;
+}
+
+// Smaller of the position's key and its mirror image's key, which the database files the position under
+static uint64_t canonicalKey(const Position& position){
+	return std::min(position.key(), position.mirroredKey());
+}
+
+EndgameDatabase::EndgameDatabase(){
+	data = 0;
+	length = 0;
+	offsets = 0;
+	keys = 0;
+	outcomes = 0;
+	count = 0;
+	rows = 0;
+	columns = 0;
+	bucketBits = 0;
+	keyBytes = 0;
+}
+
+EndgameDatabase::~EndgameDatabase(){
+	close();
+}
+
+uint32_t EndgameDatabase::bucketOf(uint64_t key, unsigned int bits){
+	if(bits == 0){
+		return 0;
+	}
+	// The keys of neighbouring positions differ in a few low bits, so they are mixed before taking the top bits
+	key ^= key >> 30;
+	key *= 0xbf58476d1ce4e5b9ULL;
+	key ^= key >> 27;
+	key *= 0x94d049bb133111ebULL;
+	key ^= key >> 31;
+	return (uint32_t)(key >> (64 - bits));
+}
+
+bool EndgameDatabase::generate(const std::string& path, unsigned int rows, unsigned int columns){
+	if(!Position::fits(rows, columns)){
+		return false;
+	}
+	Position start(rows, columns);
+	rows = start.rowCount();
+	columns = start.columnCount();
+	unsigned int cells = rows * columns;
+
+	// List the positions one move at a time, keeping one of each position and its mirror image. A full grid ends the
+	// game, so the last layer holds positions with one cell left
+	std::vector<std::vector<uint64_t> > layers(1, std::vector<uint64_t>(1, canonicalKey(start)));
+	uint64_t total = 1;
+	for(unsigned int moveCount = 1; moveCount < cells; moveCount++){
+		const std::vector<uint64_t>& previous = layers.back();
+		std::vector<uint64_t> next;
+		for(uint64_t i = 0; i < previous.size(); i++){
+			Position position(rows, columns, previous[i]);
+			for(unsigned int c = 0; c < columns; c++){
+				if(!position.canPlay(c) || position.isWinningMove(c)){
+					continue;
+				}
+				Position child(position);
+				child.play(c);
+				next.push_back(canonicalKey(child));
+			}
+		}
+		std::sort(next.begin(), next.end());
+		next.erase(std::unique(next.begin(), next.end()), next.end());
+		if(next.empty()){
+			break;
+		}
+		total += next.size();
+		if(total >= ((uint64_t)1 << 32)){
+			return false;
+		}
+		layers.push_back(std::vector<uint64_t>());
+		layers.back().swap(next);
+	}
+
+	// Size the buckets now, so each layer can be filed into them as soon as nothing needs it any more
+	unsigned int bucketBits = 0;
+	while((total >> bucketBits) > BUCKET_ENTRIES){
+		bucketBits++;
+	}
+	uint64_t buckets = (uint64_t)1 << bucketBits;
+	std::vector<uint32_t> starts(buckets + 1, 0);
+	for(unsigned int d = 0; d < layers.size(); d++){
+		for(uint64_t i = 0; i < layers[d].size(); i++){
+			starts[bucketOf(layers[d][i], bucketBits) + 1]++;
+		}
+	}
+	for(uint64_t b = 0; b < buckets; b++){
+		starts[b + 1] += starts[b];
+	}
+	std::vector<uint64_t> sortedKeys(total);
+	std::vector<unsigned char> sortedOutcomes(total);
+	std::vector<uint32_t> filled(starts.begin(), starts.end() - 1);
+
+	// Solve the layers from the last move back, each from the outcomes of the layer after it
+	std::vector<unsigned char> after;
+	for(unsigned int d = layers.size(); d-- > 0;){
+		std::vector<unsigned char> outcomes(layers[d].size());
+		for(uint64_t i = 0; i < layers[d].size(); i++){
+			Position position(rows, columns, layers[d][i]);
+			if(position.canWinNext()){
+				outcomes[i] = EO_WIN;
+				continue;
+			}
+			unsigned char best = EO_LOSS;
+			for(unsigned int c = 0; c < columns && best != EO_WIN; c++){
+				if(!position.canPlay(c)){
+					continue;
+				}
+				Position child(position);
+				child.play(c);
+				if(child.moveCount() == cells){
+					// filling the grid without four in a row draws
+					best = std::max(best, (unsigned char)EO_DRAW);
+					continue;
+				}
+				const std::vector<uint64_t>& next = layers[d + 1];
+				uint64_t index = std::lower_bound(next.begin(), next.end(), canonicalKey(child)) - next.begin();
+				// The child's outcome is the opponent's
+				best = std::max(best, (unsigned char)(EO_WIN - after[index]));
+			}
+			outcomes[i] = best;
+		}
+		if(d + 1 < layers.size()){
+			std::vector<uint64_t>().swap(layers[d + 1]);
+		}
+		after.swap(outcomes);
+		for(uint64_t i = 0; i < layers[d].size(); i++){
+			uint32_t slot = filled[bucketOf(layers[d][i], bucketBits)]++;
+			sortedKeys[slot] = layers[d][i];
+			sortedOutcomes[slot] = after[i];
+		}
+	}
+	for(uint64_t b = 0; b < buckets; b++){
+		// Buckets are small, so an insertion sort does
+		for(uint32_t i = starts[b] + 1; i < starts[b + 1]; i++){
+			uint64_t key = sortedKeys[i];
+			unsigned char outcome = sortedOutcomes[i];
+			uint32_t j = i;
+			for(; j > starts[b] && sortedKeys[j - 1] > key; j--){
+				sortedKeys[j] = sortedKeys[j - 1];
+				sortedOutcomes[j] = sortedOutcomes[j - 1];
+			}
+			sortedKeys[j] = key;
+			sortedOutcomes[j] = outcome;
+		}
+	}
+
+	DatabaseHeader header;
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.rows = rows;
+	header.columns = columns;
+	header.bucketBits = bucketBits;
+	header.keyBytes = keyBytesFor(rows, columns);
+	header.count = total;
+	std::vector<unsigned char> packedKeys(total * header.keyBytes);
+	for(uint64_t i = 0; i < total; i++){
+		for(unsigned int b = 0; b < header.keyBytes; b++){
+			packedKeys[i * header.keyBytes + b] = (unsigned char)(sortedKeys[i] >> (8 * b));
+		}
+	}
+	std::vector<unsigned char> packedOutcomes((total + 3) / 4, 0);
+	for(uint64_t i = 0; i < total; i++){
+		packedOutcomes[i / 4] |= sortedOutcomes[i] << (2 * (i % 4));
+	}
+	std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)&starts[0], starts.size() * sizeof(uint32_t));
+	file.write((const char*)&packedKeys[0], packedKeys.size());
+	file.write((const char*)&packedOutcomes[0], packedOutcomes.size());
+	file.close();
+	return !file.fail();
+}
+
+bool EndgameDatabase::open(const std::string& path){
+	close();
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0){
+		return false;
+	}
+	struct stat info;
+	void* mapped = MAP_FAILED;
+	if(fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(DatabaseHeader)){
+		mapped = mmap(0, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	}
+	::close(fd);	// the mapping stays valid without the descriptor
+	if(mapped == MAP_FAILED){
+		return false;
+	}
+
+	const DatabaseHeader* header = (const DatabaseHeader*)mapped;
+	size_t size = info.st_size;
+	bool valid = std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0 && header->version == VERSION
+		&& Position::fits(header->rows, header->columns) && header->rows >= 4 && header->columns >= 4
+		&& header->keyBytes == keyBytesFor(header->rows, header->columns) && header->bucketBits < 32
+		&& header->count < ((uint64_t)1 << 32);
+	uint64_t buckets = valid ? (uint64_t)1 << header->bucketBits : 0;
+	valid = valid && size == sizeof(DatabaseHeader) + (buckets + 1) * sizeof(uint32_t)
+		+ header->count * header->keyBytes + (header->count + 3) / 4;
+	// Offsets that run backwards or past the entries would send a probe outside the file
+	const uint32_t* bucketStarts = (const uint32_t*)((const unsigned char*)mapped + sizeof(DatabaseHeader));
+	for(uint64_t b = 0; valid && b < buckets; b++){
+		valid = bucketStarts[b] <= bucketStarts[b + 1];
+	}
+	valid = valid && bucketStarts[0] == 0 && bucketStarts[buckets] == header->count;
+	if(!valid){
+		munmap(mapped, size);
+		return false;
+	}
+	data = (const unsigned char*)mapped;
+	length = size;
+	count = header->count;
+	rows = header->rows;
+	columns = header->columns;
+	bucketBits = header->bucketBits;
+	keyBytes = header->keyBytes;
+	offsets = bucketStarts;
+	keys = (const unsigned char*)(offsets + buckets + 1);
+	outcomes = keys + count * keyBytes;
+	return true;
+}
+
+void EndgameDatabase::close(){
+	if(data != 0){
+		munmap((void*)data, length);
+	}
+	data = 0;
+	length = 0;
+	offsets = 0;
+	keys = 0;
+	outcomes = 0;
+	count = 0;
+	rows = 0;
+	columns = 0;
+	bucketBits = 0;
+	keyBytes = 0;
+}
+
+bool EndgameDatabase::probe(const Position& position, Outcome& outcome) const{
+	if(data == 0 || position.rowCount() != rows || position.columnCount() != columns){
+		return false;
+	}
+	uint64_t wanted = canonicalKey(position);
+	uint32_t bucket = bucketOf(wanted, bucketBits);
+	for(uint32_t i = offsets[bucket]; i < offsets[bucket + 1]; i++){
+		const unsigned char* stored = keys + (uint64_t)i * keyBytes;
+		uint64_t key = 0;
+		for(unsigned int b = keyBytes; b-- > 0;){
+			key = (key << 8) | stored[b];
+		}
+		if(key >= wanted){
+			if(key != wanted){
+				break;	// keys are in increasing order within a bucket
+			}
+			outcome = (Outcome)((outcomes[i / 4] >> (2 * (i % 4))) & 3);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool EndgameDatabase::probe(const Game& game, Outcome& outcome) const{
+	// A SuperGame or a longer line to win changes the outcome of the same discs
+	if(typeid(game) != typeid(Game) || game.winLength() != 4 || game.status() != Game::GS_IN_PROGRESS){
+		return false;
+	}
+	const Grid* grid = game.grid();
+	if(grid == 0 || grid->rowCount() != rows || grid->columnCount() != columns){
+		return false;
+	}
+	return probe(Position(*grid), outcome);
+}
@@ -0,0 +1,131 @@
+#ifndef ENDGAMEDATABASE_HPP
+#define ENDGAMEDATABASE_HPP
+
+#include "Position.hpp"
+#include "Game.hpp"
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+
+/*
+An EndgameDatabase holds whether the player to move wins, draws or loses with perfect play in every position of a small
+grid size, so that on grids small enough to solve outright (4x4 up to about 5x5 or 4x6) a single lookup replaces any
+search.
+
+A database is written once with `generate`, which solves the positions backwards rather than searching them: every
+position reachable from the empty grid is listed, a move at a time, and the positions are then solved from the last
+move back to the first, each from the already known outcomes of the positions its moves lead to. It is read with `open`,
+which maps the file into memory as an OpeningBook does. As in a book, a position and its mirror image share an entry,
+and positions where the game is already over are not held.
+
+Entries are found by hashing instead of searching: the keys (see `Position::key`) are grouped into buckets of about
+eight by the top bits of a hash of the key, so a probe reads the bucket's two offsets and then scans a handful of keys
+stored next to each other. Each key only takes as many bytes as a key of the grid size needs, and each outcome takes two
+bits, so a 4x4 database takes under four bytes per position, about 250 KB in all.
+
+The file holds, in the byte order of the machine that wrote it, a 32-byte header:
+
+    char     magic[4]       "C4ED"
+    uint32_t version        1
+    uint32_t rows
+    uint32_t columns
+    uint32_t bucketBits     there are 2^bucketBits buckets
+    uint32_t keyBytes       bytes held for each key
+    uint64_t count          number of entries
+
+followed by 2^bucketBits + 1 32-bit offsets, bucket b holding entries [offset b, offset b + 1). Then come `count` keys,
+each as its low `keyBytes` bytes with the least significant first and in increasing order within a bucket, and finally
+the outcomes (see Outcome) packed four to a byte, entry i in bits 2 * (i % 4) and up of byte i / 4.
+
+Once open, a database is never modified, so any number of threads can probe it at once.
+*/
+class EndgameDatabase {
+public:
+    /*
+    The Outcome enum holds the result of a position with perfect play, for the player to move.
+    */
+    enum Outcome { EO_LOSS, EO_DRAW, EO_WIN };
+
+    /*
+    Create an EndgameDatabase with no file open.
+    */
+    EndgameDatabase();
+
+    /*
+    Unmap the database's file, if one is open.
+    */
+    ~EndgameDatabase();
+
+    /*
+    Solve every position of the given size and write them to a database file at `path`. Every position is held in
+    memory while it is solved, taking about 18 bytes each. Returns `false` if the grid doesn't fit a Position, it has
+    2^32 positions or more, or the file can't be written.
+    */
+    static bool generate(const std::string& path, unsigned int rows, unsigned int columns);
+
+    /*
+    Map the database file at `path` into memory, closing any database already open. Returns `false`, leaving no database
+    open, if the file can't be read or isn't a valid database.
+    */
+    bool open(const std::string& path);
+
+    /*
+    Unmap the database's file. Does nothing if no database is open.
+    */
+    void close();
+
+    /*
+    Return `true` if a database is open.
+    */
+    bool isOpen() const { return data != 0; }
+
+    /*
+    Return the number of rows of the database's positions, or 0 if no database is open.
+    */
+    unsigned int rowCount() const { return rows; }
+
+    /*
+    Return the number of columns of the database's positions, or 0 if no database is open.
+    */
+    unsigned int columnCount() const { return columns; }
+
+    /*
+    Return the number of entries in the database.
+    */
+    uint64_t size() const { return count; }
+
+    /*
+    Look the position up, filling in its outcome for the player to move. Returns `false` if the position isn't in the
+    database: it's the wrong size, the game is over, or it can't be reached in a game.
+    */
+    bool probe(const Position& position, Outcome& outcome) const;
+
+    /*
+    Look the current position of the game up, as above. Returns `false` unless the game is an in progress standard Game
+    (four in a row to win) of the database's size.
+    */
+    bool probe(const Game& game, Outcome& outcome) const;
+
+private:
+    /*
+    Private copy constructor and assignment operator - the mapping belongs to a single database.
+    */
+    EndgameDatabase(const EndgameDatabase&);
+    EndgameDatabase& operator=(const EndgameDatabase&);
+
+    // Bucket of the key, among 2^bits buckets
+    static uint32_t bucketOf(uint64_t key, unsigned int bits);
+
+    const unsigned char* data;  // the mapped file
+    size_t length;
+    const uint32_t* offsets;
+    const unsigned char* keys;
+    const unsigned char* outcomes;
+    uint64_t count;
+    unsigned int rows;
+    unsigned int columns;
+    unsigned int bucketBits;
+    unsigned int keyBytes;
+};
+
+#endif /* end of include guard: ENDGAMEDATABASE_HPP */
@@ -1,4 +1,6 @@
 #include "Game.hpp"
+#include "Position.hpp"
+#include "Snapshot.hpp"
 
 Game::Game(){
 	// Initialising variables
@@ -8,6 +10,8 @@ Game::Game(){
 	gameStatus = GS_INVALID;
 	turn = 0;
 	playersDisc = Grid::GC_EMPTY;
+	winCheckMethod = WC_BITBOARD;
+	lineLength = 4;
 }
 
 Game::~Game(){
@@ -16,11 +20,42 @@ Game::~Game(){
 	board = 0;
 }
 
+Game::Game(const Game& other){
+	board = 0;
+	*this = other;
+}
+
+Game& Game::operator=(const Game& other){
+	// Copy the other game's grid rather than sharing it, as each game deletes its own grid
+	if(this != &other){
+		delete board;
+		board = (other.board != 0) ? new Grid(*other.board) : 0;
+		playerOne = other.playerOne;
+		playerTwo = other.playerTwo;
+		gameStatus = other.gameStatus;
+		turn = other.turn;
+		playersDisc = other.playersDisc;
+		winCheckMethod = other.winCheckMethod;
+		lineLength = other.lineLength;
+		history = other.history;
+	}
+	return *this;
+}
+
+Game* Game::clone() const{
+	return new Game(*this);
+}
+
 void Game::setGrid(Grid* grid){
 	// Setting board as the grid assigned. Game status becomes in progress if player one and player two are assigned
 	if(grid != 0){
 		delete board;	// delete previously assigned grid. Safe to delete a null pointer
 		board = grid;
+		// a move can only ever fill an empty cell, so the stack never outgrows the grid. Huge grids grow it as they're
+		// played instead of reserving a slot for every cell
+		history.clear();
+		unsigned int cells = grid->rowCount() * grid->columnCount();
+		history.reserve(cells < MAX_RESERVED_MOVES ? cells : MAX_RESERVED_MOVES);
 		if(playerOne != 0 && playerTwo != 0){
 			gameStatus = GS_IN_PROGRESS;
 		}
@@ -58,6 +93,7 @@ void Game::restart(){
 		playerTwo->resetScore();
 		gameStatus = GS_IN_PROGRESS;
 		turn = 0;
+		history.clear();
 	}
 }
 
@@ -94,17 +130,51 @@ const Player* Game::nextPlayer() const{
 	return 0;
 }
 
+const Grid* Game::grid() const{
+	return board;
+}
+
+unsigned int Game::turnCount() const{
+	return turn;
+}
+
+unsigned int Game::score(Grid::Cell disc) const{
+	Player* player = disc == Grid::GC_PLAYER_ONE ? playerOne : (disc == Grid::GC_PLAYER_TWO ? playerTwo : 0);
+	return player != 0 ? player->getScore() : 0;
+}
+
+void Game::setWinCheck(WinCheck method){
+	winCheckMethod = method;
+}
+
+Game::WinCheck Game::winCheck() const{
+	return winCheckMethod;
+}
+
+void Game::setWinLength(unsigned int length){
+	if(length < 2){
+		lineLength = 2;
+	} else if(length > Grid::MAX_LINE_LENGTH){
+		lineLength = Grid::MAX_LINE_LENGTH;
+	} else {
+		lineLength = length;
+	}
+}
+
+unsigned int Game::winLength() const{
+	return lineLength;
+}
+
 bool Game::checkForWinner(unsigned int column, Grid::Cell disc){
-	// find the row of the column (j) which is empty
-	int j = -1;
-	for(unsigned int i = 0; i < board->rowCount(); i++){
-		if(board->cellAt(i, column) == Grid::GC_EMPTY){
-			j++;
-		}
+	// row (j) of the recent disc inserted, which sits on top of its column
+	int j = board->rowCount() - board->columnHeight(column);
+
+	// Let the grid test the player's bitboard unless a cell by cell scan was asked for
+	if(winCheckMethod == WC_BITBOARD){
+		return board->connectsLine(j, column, disc, lineLength);
 	}
-	j++;	// recent disc inserted
 
-	// Checking for any connect 4s on all directions
+	// Checking for any winning lines on all directions
 	if (check_diagonal_combo_SW_NE(column,j,disc )) {
 		return true;
 	}
@@ -122,7 +192,7 @@ bool Game::checkForWinner(unsigned int column, Grid::Cell disc){
 	}
 }
 
-bool Game::check_diagonal_combo_SW_NE(int x, int y, Grid::Cell player){
+bool Game::check_diagonal_combo_SW_NE(int x, int y, Grid::Cell player) const{
 	int score = 1;
 	int count = 1;
 
@@ -147,7 +217,7 @@ bool Game::check_diagonal_combo_SW_NE(int x, int y, Grid::Cell player){
 		}
 	}
 
-	if (score >= 4) {	// if score is atleast 4 then there is connect 4
+	if (score >= (int)lineLength) {	// if score is atleast the win length then there is a winning line
 		return true;
 	}
 	else {
@@ -155,7 +225,7 @@ bool Game::check_diagonal_combo_SW_NE(int x, int y, Grid::Cell player){
 	}
 }
 
-bool Game::check_diagonal_combo_NW_SE(int x, int y, Grid::Cell player){
+bool Game::check_diagonal_combo_NW_SE(int x, int y, Grid::Cell player) const{
 	int score = 1;
 	int count = 1;
 
@@ -176,7 +246,7 @@ bool Game::check_diagonal_combo_NW_SE(int x, int y, Grid::Cell player){
 		else break;  //If no combo is detected break from the loop
 	}
 
-	if (score >= 4) {	// if score is atleast 4 then there is connect 4
+	if (score >= (int)lineLength) {	// if score is atleast the win length then there is a winning line
 		return true;
 	}
 	else {
@@ -184,7 +254,7 @@ bool Game::check_diagonal_combo_NW_SE(int x, int y, Grid::Cell player){
 	}
 }
 
-bool Game::check_vertical_combo(int x, int y, Grid::Cell player){
+bool Game::check_vertical_combo(int x, int y, Grid::Cell player) const{
 	int score = 1;
 	int count = 1;
 
@@ -209,7 +279,7 @@ bool Game::check_vertical_combo(int x, int y, Grid::Cell player){
 		}
 	}
 
-	if (score >= 4) {	// if score is atleast 4 then there is connect 4
+	if (score >= (int)lineLength) {	// if score is atleast the win length then there is a winning line
 		return true;
 	}
 	else {
@@ -217,7 +287,7 @@ bool Game::check_vertical_combo(int x, int y, Grid::Cell player){
 	}
 }
 
-bool Game::check_horizontal_combo(int x, int y, Grid::Cell player)
+bool Game::check_horizontal_combo(int x, int y, Grid::Cell player) const
 {
 	int score = 1;
 	int count = 1;
@@ -243,7 +313,7 @@ bool Game::check_horizontal_combo(int x, int y, Grid::Cell player)
 		}
 	}
 
-	if (score >= 4) {		// if score is atleast 4 then there is connect 4
+	if (score >= (int)lineLength) {		// if score is atleast the win length then there is a winning line
 		return true;
 	}
 	else {
@@ -257,35 +327,86 @@ bool Game::playNextTurn(unsigned int column){
 	// If winner is detected it changes game status and increases score and wins for player and increments turn
 	// if turn is equal to row count multiplied by column count means all the moves have been played
 	// game status is changed to complete but no wins or scores are updated
+	// Every move is pushed onto the move stack so it can be taken back
 	if(gameStatus == GS_IN_PROGRESS){
-		if(nextPlayer() == playerOne){
-			if(board->insertDisc(column, Grid::GC_PLAYER_ONE)){
-				if(checkForWinner(column, Grid::GC_PLAYER_ONE)){
-					gameStatus = GS_COMPLETE;
-					playerOne->increaseScore();
-					playerOne->increaseWins();
-				}
-				turn++;
-				if(turn == board->rowCount() * board->columnCount()){
-					gameStatus = GS_COMPLETE;
-				}
-				return true;
+		Player* player = nextPlayer() == playerOne ? playerOne : playerTwo;
+		Grid::Cell disc = player == playerOne ? Grid::GC_PLAYER_ONE : Grid::GC_PLAYER_TWO;
+		if(board->insertDisc(column, disc)){
+			Move move = { column, false };
+			if(checkForWinner(column, disc)){
+				gameStatus = GS_COMPLETE;
+				player->increaseScore();
+				player->increaseWins();
+				move.won = true;
 			}
-		} else {
-			if(board->insertDisc(column, Grid::GC_PLAYER_TWO )){
-				if(checkForWinner(column, Grid::GC_PLAYER_TWO)){
-					gameStatus = GS_COMPLETE;
-					playerTwo->increaseScore();
-					playerTwo->increaseWins();
-				}
-				turn++;
-				if(turn == board->rowCount() * board->columnCount()){
-					gameStatus = GS_COMPLETE;
-				}
-				return true;
+			history.push_back(move);
+			turn++;
+			if(turn == board->rowCount() * board->columnCount()){
+				gameStatus = GS_COMPLETE;
 			}
+			return true;
 		}
-	} else	{
+	}
+	// the game is not in progress or the column could not take another disc
+	return false;
+}
+
+bool Game::undoMove(){
+	if(history.empty()){
+		return false;
+	}
+	// The player who made the move is the one whose turn it was, and only a winning move changed any scores
+	Move move = history.back();
+	history.pop_back();
+	turn--;
+	board->removeDisc(move.column);
+	if(move.won){
+		Player* player = turn % 2 == 0 ? playerOne : playerTwo;
+		player->decreaseScore();
+		player->decreaseWins();
+	}
+	gameStatus = GS_IN_PROGRESS;
+	return true;
+}
+
+bool Game::supportsUndo() const{
+	return true;
+}
+
+unsigned int Game::undoableMoves() const{
+	return history.size();
+}
+
+Snapshot Game::snapshot() const{
+	Snapshot result;
+	if(board == 0 || !Position::fits(board->rowCount(), board->columnCount())){
+		return result;
+	}
+	result.boards[0] = board->bitboard(Grid::GC_PLAYER_ONE);
+	result.boards[1] = board->bitboard(Grid::GC_PLAYER_TWO);
+	result.scores[0] = playerOne != 0 ? playerOne->getScore() : 0;
+	result.scores[1] = playerTwo != 0 ? playerTwo->getScore() : 0;
+	result.turn = turn;
+	result.rows = board->rowCount();
+	result.columns = board->columnCount();
+	result.gameStatus = gameStatus;
+	result.lineLength = lineLength;
+	return result;
+}
+
+bool Game::restore(const Snapshot& snapshot){
+	if(!snapshot.valid() || playerOne == 0 || playerTwo == 0){
 		return false;
 	}
+	if(board == 0 || board->rowCount() != snapshot.rowCount() || board->columnCount() != snapshot.columnCount()){
+		setGrid(new Grid(snapshot.rowCount(), snapshot.columnCount()));
+	}
+	board->setBitboards(snapshot.bitboard(Grid::GC_PLAYER_ONE), snapshot.bitboard(Grid::GC_PLAYER_TWO));
+	playerOne->setScore(snapshot.score(Grid::GC_PLAYER_ONE));
+	playerTwo->setScore(snapshot.score(Grid::GC_PLAYER_TWO));
+	turn = snapshot.turnCount();
+	gameStatus = snapshot.status();
+	lineLength = snapshot.winLength();
+	history.clear();
+	return true;
 }
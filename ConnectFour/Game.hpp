@@ -3,6 +3,9 @@
 
 #include "Player.hpp"
 #include "Grid.hpp"
+#include <vector>
+
+class Snapshot;
 
 /*
 The game class oversees all game logic and state. Once a game is created it must be assigned two players and a grid
@@ -27,6 +30,13 @@ public:
     */
     enum Status { GS_IN_PROGRESS, GS_COMPLETE, GS_INVALID };
 
+    /*
+    The WinCheck enum selects how `checkForWinner` looks for four in a row after each move. WC_BITBOARD (the default)
+    asks the Grid to test the player's bitboard with a constant number of shift and AND operations. WC_SCAN walks out
+    from the inserted disc cell by cell using the check_*_combo methods.
+    */
+    enum WinCheck { WC_BITBOARD, WC_SCAN };
+
     /*
     Create a new game. The game status will be set to GS_INVALID until both players and a grid have all been set using
     the appropriate setter methods.
@@ -39,6 +49,25 @@ public:
     */
     virtual ~Game();
 
+    /*
+    Create a copy of another Game, with a copy of its grid (if it has one) that the new Game owns, its move stack and
+    the rest of its state. The players are shared with the original game, as a Game never owns its players, so playing
+    either game updates the same players' scores and wins.
+    */
+    Game(const Game& other);
+
+    /*
+    Replace the state of this Game with a copy of another Game's, in the same way as the copy constructor. The grid
+    previously owned by this Game is deleted.
+    */
+    Game& operator=(const Game& other);
+
+    /*
+    Return a heap-allocated copy of this game (see the copy constructor), of the same type as this game. The caller owns
+    the copy.
+    */
+    virtual Game* clone() const;
+
 
     /*
     Set the Grid used by this Game. Any Grid previously assigned to this game will be deleted before the new one is
@@ -95,6 +124,22 @@ public:
     */
     virtual const Player* nextPlayer() const;
 
+    /*
+    Get the Grid assigned to this Game, or a null pointer (0) if no grid has been assigned yet.
+    */
+    const Grid* grid() const;
+
+    /*
+    Get the number of turns played since the game was created or last restarted.
+    */
+    unsigned int turnCount() const;
+
+    /*
+    Get the score of Player One (for GC_PLAYER_ONE) or Player Two (for GC_PLAYER_TWO), or 0 for GC_EMPTY or a player
+    that hasn't been assigned yet.
+    */
+    unsigned int score(Grid::Cell disc) const;
+
     /*
     Execute the turn of the next player by attempting to insert a disc into the indicated column of the game grid. If
     the move was successful, this method should return `true`. If the move was could not be completed (e.g. the
@@ -105,24 +150,82 @@ public:
     */
     virtual bool playNextTurn(unsigned int column);
 
-    // It checks for winner so checks for any connect 4 in any direction
+    /*
+    Take back the last move played with `playNextTurn`, restoring the grid, the turn, the game status and the scores and
+    win counts of both players exactly as they were before it. Returns `false`, changing nothing, if there is no move to
+    take back: none has been played since the grid was assigned or the game was restarted.
+
+    Every move played is kept on a move stack, which never holds more moves than the grid has cells. Its space is
+    reserved when the grid is assigned, so playing and taking back moves takes constant time and never allocates, and a
+    search can explore the game in place instead of copying it at every step.
+    */
+    virtual bool undoMove();
+
+    /*
+    Return `true` if the moves of this kind of game are kept on the move stack, so `undoMove` can take them back.
+    */
+    virtual bool supportsUndo() const;
+
+    /*
+    Get the number of moves `undoMove` can take back.
+    */
+    unsigned int undoableMoves() const;
+
+    /*
+    Take a Snapshot of the game: the discs on the grid, the turns played, the status, both players' scores and the win
+    length. The Snapshot is invalid if the game has no grid or its grid is too large for a Snapshot. Takes time
+    proportional to the number of columns.
+    */
+    Snapshot snapshot() const;
+
+    /*
+    Put the game back into the state held by the Snapshot, replacing the grid (with a new one if the dimensions differ),
+    the turns played, the status, the win length and both players' scores. The move stack is emptied, so the moves that
+    led to the Snapshot can't be taken back. Returns `false`, changing nothing, if the Snapshot is invalid or the game
+    does not have both players assigned yet.
+    */
+    virtual bool restore(const Snapshot& snapshot);
+
+    /*
+    Select the method used by `checkForWinner`. See the WinCheck enum for the available methods.
+    */
+    void setWinCheck(WinCheck method);
+
+    /*
+    Get the method currently used by `checkForWinner`.
+    */
+    WinCheck winCheck() const;
+
+    /*
+    Set the number of discs in a row a player needs to win (4 by default). Lengths below 2 are corrected to 2, and
+    lengths above Grid::MAX_LINE_LENGTH to Grid::MAX_LINE_LENGTH. The length is kept when the game is restarted, and
+    should be set before play starts. In a SuperGame this is also the length of the lines that are cleared.
+    */
+    void setWinLength(unsigned int length);
+
+    /*
+    Get the number of discs in a row a player needs to win.
+    */
+    unsigned int winLength() const;
+
+    // It checks for winner so checks for any line of winLength() discs in any direction
 
     virtual bool checkForWinner(unsigned int column, Grid::Cell disc);
 
     // checks horizontal combo around a particular cell
-    bool check_horizontal_combo(int x, int y, Grid::Cell player);
+    bool check_horizontal_combo(int x, int y, Grid::Cell player) const;
 
     // checks vertical combo around a particular cell
 
-    bool check_vertical_combo(int x, int y, Grid::Cell player);
+    bool check_vertical_combo(int x, int y, Grid::Cell player) const;
 
     // checks diagonal combo (\) around a particular cell
 
-    bool check_diagonal_combo_NW_SE(int x, int y, Grid::Cell player);
+    bool check_diagonal_combo_NW_SE(int x, int y, Grid::Cell player) const;
 
     // checks diagonal combo (/) around a particular cell
 
-    bool check_diagonal_combo_SW_NE(int x, int y, Grid::Cell player);
+    bool check_diagonal_combo_SW_NE(int x, int y, Grid::Cell player) const;
 
 protected:
     // Declaring variables as protected so derived class can inherit
@@ -132,6 +235,17 @@ protected:
     Status gameStatus;
     unsigned int turn;
     Grid::Cell playersDisc;
+    WinCheck winCheckMethod;
+    unsigned int lineLength;    // discs in a row needed to win
+
+    // A move on the move stack
+    struct Move {
+        unsigned int column;
+        bool won;               // the move won the game for the player who made it
+    };
+    std::vector<Move> history;
+    // Most moves reserved on the move stack when a grid is set
+    static const unsigned int MAX_RESERVED_MOVES = 1 << 16;
 };
 
 #endif /* end of include guard: GAME_HPP */
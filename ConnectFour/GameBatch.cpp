@@ -0,0 +1,178 @@
+#include "GameBatch.hpp"
+#include "Position.hpp"
+
+GameBatch::GameBatch(unsigned int count, unsigned int rows, unsigned int columns){
+	// Adjusting for boundaries in the same way as the Grid
+	rows = (rows < 4) ? 4 : rows;
+	columns = (columns < 4) ? 4 : columns;
+	if(!Position::fits(rows, columns)){
+		rows = 6;
+		columns = 7;
+	}
+	this->rows = rows;
+	this->columns = columns;
+	stride = rows + 1;
+	board = 0;
+	for(unsigned int c = 0; c < 16; c++){
+		bottomMasks[c] = c < columns ? (uint64_t)1 << (c * stride) : 0;
+		columnMasks[c] = bottomMasks[c] * ((((uint64_t)1) << rows) - 1);
+		board |= columnMasks[c];
+	}
+	current.assign(count, 0);
+	mask.assign(count, 0);
+	moves.assign(count, 0);
+	statuses.assign(count, Game::GS_IN_PROGRESS);
+	winners.assign(count, Grid::GC_EMPTY);
+}
+
+void GameBatch::restart(){
+	for(unsigned int i = 0; i < size(); i++){
+		restart(i);
+	}
+}
+
+void GameBatch::restart(unsigned int game){
+	current[game] = 0;
+	mask[game] = 0;
+	moves[game] = 0;
+	statuses[game] = Game::GS_IN_PROGRESS;
+	winners[game] = Grid::GC_EMPTY;
+}
+
+unsigned int GameBatch::restartFinished(){
+	unsigned int restarted = 0;
+	for(unsigned int i = 0; i < size(); i++){
+		if(statuses[i] == Game::GS_COMPLETE){
+			restart(i);
+			restarted++;
+		}
+	}
+	return restarted;
+}
+
+template <unsigned int Stride>
+unsigned int GameBatch::stepWithStride(const unsigned char* columns){
+	const unsigned int count = size();
+	const unsigned int s = Stride != 0 ? Stride : stride;
+	uint64_t* currents = current.data();
+	uint64_t* masks = mask.data();
+	unsigned char* played = moves.data();
+	unsigned char* status = statuses.data();
+	unsigned char* winner = winners.data();
+	unsigned int discs = 0;
+	for(unsigned int i = 0; i < count; i++){
+		// Columns past the grid index the empty masks at the end of the tables, so they never play
+		unsigned int column = columns[i] < this->columns ? columns[i] : 15;
+		uint64_t live = (uint64_t)0 - (uint64_t)(status[i] == Game::GS_IN_PROGRESS);
+		uint64_t occupied = masks[i];
+		uint64_t move = (occupied + bottomMasks[column]) & columnMasks[column] & live;
+		uint64_t mover = currents[i] | move;
+		occupied |= move;
+
+		// Four in a row for the player who just moved, in each of the four directions (see Position::hasFour)
+		uint64_t pairs = mover & (mover >> 1);
+		uint64_t lines = pairs & (pairs >> 2);
+		pairs = mover & (mover >> s);
+		lines |= pairs & (pairs >> (2 * s));
+		pairs = mover & (mover >> (s - 1));
+		lines |= pairs & (pairs >> (2 * (s - 1)));
+		pairs = mover & (mover >> (s + 1));
+		lines |= pairs & (pairs >> (2 * (s + 1)));
+
+		unsigned int moved = move != 0;
+		unsigned int won = (lines != 0) & moved;
+		unsigned int full = occupied == board;
+		// The turn only passes on when a disc was played
+		uint64_t keep = (uint64_t)moved - 1;
+		currents[i] = ((mover ^ occupied) & ~keep) | (currents[i] & keep);
+		masks[i] = occupied;
+		played[i] += moved;
+		// Player One makes the odd numbered moves
+		unsigned char disc = (played[i] & 1) ? (unsigned char)Grid::GC_PLAYER_ONE : (unsigned char)Grid::GC_PLAYER_TWO;
+		winner[i] = won ? disc : winner[i];
+		status[i] = (won | full) ? (unsigned char)Game::GS_COMPLETE : status[i];
+		discs += moved;
+	}
+	return discs;
+}
+
+unsigned int GameBatch::step(const unsigned char* columns){
+	switch(stride){
+	case 5:
+		return stepWithStride<5>(columns);
+	case 6:
+		return stepWithStride<6>(columns);
+	case 7:
+		return stepWithStride<7>(columns);
+	case 8:
+		return stepWithStride<8>(columns);
+	case 9:
+		return stepWithStride<9>(columns);
+	default:
+		return stepWithStride<0>(columns);
+	}
+}
+
+uint32_t GameBatch::openColumns(unsigned int game) const{
+	if(statuses[game] != Game::GS_IN_PROGRESS){
+		return 0;
+	}
+	// A column is playable while its top cell is empty
+	uint64_t tops = ~mask[game] >> (rows - 1);
+	uint32_t open = 0;
+	for(unsigned int c = 0; c < columns; c++){
+		open |= (uint32_t)((tops >> (c * stride)) & 1) << c;
+	}
+	return open;
+}
+
+void GameBatch::playableColumns(uint32_t* playable) const{
+	for(unsigned int i = 0; i < size(); i++){
+		playable[i] = openColumns(i);
+	}
+}
+
+void GameBatch::chooseRandomColumns(unsigned char* columns, uint64_t& state) const{
+	const unsigned int count = size();
+	const uint64_t topCells = board & ~(board >> 1);	// the top cell of every column
+	for(unsigned int i = 0; i < count; i++){
+		columns[i] = 0;
+		uint64_t open = ~mask[i] & topCells;
+		if(statuses[i] != Game::GS_IN_PROGRESS || open == 0){
+			continue;
+		}
+		// Draw columns until one is open: most columns are open for most of a game, so this rarely takes long
+		unsigned int column;
+		do {
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			column = (unsigned int)(((state >> 32) * this->columns) >> 32);
+		} while((open & columnMasks[column]) == 0);
+		columns[i] = (unsigned char)column;
+	}
+}
+
+unsigned int GameBatch::inProgress() const{
+	unsigned int count = 0;
+	for(unsigned int i = 0; i < size(); i++){
+		count += statuses[i] == Game::GS_IN_PROGRESS;
+	}
+	return count;
+}
+
+uint64_t GameBatch::bitboard(unsigned int game, Grid::Cell disc) const{
+	if(disc == Grid::GC_EMPTY){
+		return 0;
+	}
+	// The player to move is Player One after an even number of moves
+	bool currentIsOne = moves[game] % 2 == 0;
+	return (currentIsOne == (disc == Grid::GC_PLAYER_ONE)) ? current[game] : current[game] ^ mask[game];
+}
+
+bool GameBatch::copyTo(unsigned int game, Grid& grid) const{
+	if(grid.rowCount() != rows || grid.columnCount() != columns){
+		return false;
+	}
+	return grid.setBitboards(bitboard(game, Grid::GC_PLAYER_ONE), bitboard(game, Grid::GC_PLAYER_TWO));
+}
@@ -0,0 +1,136 @@
+#ifndef GAMEBATCH_HPP
+#define GAMEBATCH_HPP
+
+#include "Game.hpp"
+#include "Grid.hpp"
+#include <stdint.h>
+#include <vector>
+
+/*
+GameBatch plays many independent standard games (four in a row wins, a full grid is a draw) side by side, one move of
+every game per call, for generating training data where a Game object per game would spend most of its time following
+pointers. Every game has the same size, which must fit a Position (see `Position::fits`); Player One moves first in
+each of them.
+
+The games are held as a structure of arrays: the discs of the player to move and the occupied cells of every game are
+two arrays of bitboards laid out as in a Position, next to arrays of move counts, statuses and winners. `step` goes
+through the arrays once, finding where each disc lands, checking for four in a row with shifts and ANDs and updating
+the status without branching on any game, so the loop runs at the same speed however the games are going. As in a
+Playout, the strides of grids of 4 to 8 rows are compiled in.
+
+A column that is full, or outside the grid, leaves its game unchanged, as does any move for a game that is complete;
+`playableColumns` gives the columns each game can play and `chooseRandomColumns` picks one of them at random. Finished
+games stay as they are until they are restarted.
+*/
+class GameBatch {
+public:
+    /*
+    Create `count` empty games on grids of the given size, corrected to be at least 4x4 in the same way as a Grid. A
+    size that doesn't fit a Position gives 6x7 grids instead.
+    */
+    GameBatch(unsigned int count, unsigned int rows = 6, unsigned int columns = 7);
+
+    /*
+    Return the number of games in the batch.
+    */
+    unsigned int size() const { return (unsigned int)current.size(); }
+
+    /*
+    Return the number of rows of every grid.
+    */
+    unsigned int rowCount() const { return rows; }
+
+    /*
+    Return the number of columns of every grid.
+    */
+    unsigned int columnCount() const { return columns; }
+
+    /*
+    Empty every grid.
+    */
+    void restart();
+
+    /*
+    Empty the grid of the specified game.
+    */
+    void restart(unsigned int game);
+
+    /*
+    Empty the grids of the games that are complete, and return how many there were.
+    */
+    unsigned int restartFinished();
+
+    /*
+    Play one disc in every game that is in progress, into the column `columns[game]`, for the player whose turn it is,
+    and return the number of discs played. `columns` must hold one entry per game.
+    */
+    unsigned int step(const unsigned char* columns);
+
+    /*
+    Set `playable[game]` to a mask with bit c set for every column c the game can play, or 0 for a complete game.
+    `playable` must hold one entry per game.
+    */
+    void playableColumns(uint32_t* playable) const;
+
+    /*
+    Set `columns[game]` to a playable column of each game in progress, chosen uniformly at random using (and advancing)
+    the xorshift64 generator `state`, which must not be 0. Complete games get column 0. `columns` must hold one entry per
+    game.
+    */
+    void chooseRandomColumns(unsigned char* columns, uint64_t& state) const;
+
+    /*
+    Return the number of games still in progress.
+    */
+    unsigned int inProgress() const;
+
+    /*
+    Return GS_IN_PROGRESS or GS_COMPLETE for the specified game.
+    */
+    Game::Status status(unsigned int game) const { return (Game::Status)statuses[game]; }
+
+    /*
+    Return the disc of the winner of the specified game, or GC_EMPTY if it is a draw or still in progress. Unlike
+    `Game::winner`, four in a row made with the disc that fills the grid is a win rather than a draw.
+    */
+    Grid::Cell winner(unsigned int game) const { return (Grid::Cell)winners[game]; }
+
+    /*
+    Return the number of discs played in the specified game.
+    */
+    unsigned int moveCount(unsigned int game) const { return moves[game]; }
+
+    /*
+    Return the bitboard of the given player's discs in the specified game, in the layout of `Grid::bitboard`. Returns 0
+    for GC_EMPTY.
+    */
+    uint64_t bitboard(unsigned int game, Grid::Cell disc) const;
+
+    /*
+    Copy the discs of the specified game onto the grid, which must have the same size as the batch's grids. Returns
+    `false`, changing nothing, if it doesn't.
+    */
+    bool copyTo(unsigned int game, Grid& grid) const;
+
+private:
+    // Play one move of every game with the strides of the grid known at compile time (0 reads them from `stride`)
+    template <unsigned int Stride>
+    unsigned int stepWithStride(const unsigned char* columns);
+
+    // Mask of the columns the game can play, 0 once it is complete
+    uint32_t openColumns(unsigned int game) const;
+
+    unsigned int rows;
+    unsigned int columns;
+    unsigned int stride;
+    uint64_t board;                 // every cell of a grid
+    uint64_t bottomMasks[16];       // bottom cell of each column, 0 past the last column
+    uint64_t columnMasks[16];       // every cell of each column, 0 past the last column
+    std::vector<uint64_t> current;  // discs of the player to move, per game
+    std::vector<uint64_t> mask;     // occupied cells, per game
+    std::vector<unsigned char> moves;
+    std::vector<unsigned char> statuses;
+    std::vector<unsigned char> winners;
+};
+
+#endif /* end of include guard: GAMEBATCH_HPP */
@@ -1,4 +1,8 @@
 #include "Grid.hpp"
+#include <algorithm>
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
 
 Grid::Grid(unsigned int rows, unsigned int columns){
 	// Adjusting for boundaries
@@ -12,15 +16,80 @@ Grid::Grid(unsigned int rows, unsigned int columns){
 	} else {
 		noOfColumns = columns;
 	}
-	// Initialisation
-	board.resize(noOfRows, std::vector<Cell>(noOfColumns, GC_EMPTY));
-
+	// Initialisation: one separator bit above each column, rounded up to whole 64-bit words per player
+	stride = (uint64_t)noOfRows + 1;
+	if(stride * noOfColumns > 64){
+		// Too big for one word, so pad the columns to a power of two of up to 64 bits, or whole words, so that no column
+		// straddles a word boundary
+		uint64_t padded = 8;
+		while(padded < stride && padded < 64){
+			padded *= 2;
+		}
+		stride = (stride + padded - 1) / padded * padded;
+	}
+	words = (stride * noOfColumns + 63) / 64;
+	sparse = words > SPARSE_WORDS;
+	// Start player two's bitboard on a cache line of its own
+	planeWords = words == 1 ? 1 : (words + LINE_WORDS - 1) / LINE_WORDS * LINE_WORDS;
+	if(sparse){
+		pages.resize((words + PAGE_WORDS - 1) / PAGE_WORDS);
+	} else {
+		bitboards.assign(2 * planeWords, 0);
+	}
+	heights.assign(noOfColumns, 0);
+	filled = 0;
 }
 
 Grid::~Grid(){
 
 }
 
+uint64_t Grid::bitIndex(unsigned int row, unsigned int column) const{
+	// Columns are stored bottom-up, so the bottom row is bit 0 of its column
+	return column * stride + (noOfRows - 1 - row);
+}
+
+inline uint64_t Grid::readWord(unsigned int player, uint64_t index) const{
+	if(!sparse){
+		return bitboards[player * planeWords + index];
+	}
+	const std::vector<uint64_t>& page = pages[index / PAGE_WORDS];
+	return page.empty() ? 0 : page[player * PAGE_WORDS + index % PAGE_WORDS];
+}
+
+inline void Grid::storeWord(unsigned int player, uint64_t index, uint64_t value){
+	if(!sparse){
+		bitboards[player * planeWords + index] = value;
+		return;
+	}
+	std::vector<uint64_t>& page = pages[index / PAGE_WORDS];
+	if(page.empty()){
+		if(value == 0){
+			return;	// the page already reads as empty
+		}
+		page.assign(2 * PAGE_WORDS, 0);
+	}
+	page[player * PAGE_WORDS + index % PAGE_WORDS] = value;
+}
+
+Grid::Cell Grid::cellAtBit(uint64_t bit) const{
+	uint64_t mask = (uint64_t)1 << (bit & 63);
+	uint64_t word = bit >> 6;
+	if(readWord(0, word) & mask){
+		return GC_PLAYER_ONE;
+	} else if(readWord(1, word) & mask){
+		return GC_PLAYER_TWO;
+	}
+	return GC_EMPTY;
+}
+
+void Grid::setCellAtBit(uint64_t bit, Cell disc){
+	uint64_t mask = (uint64_t)1 << (bit & 63);
+	uint64_t word = bit >> 6;
+	storeWord(0, word, (readWord(0, word) & ~mask) | (disc == GC_PLAYER_ONE ? mask : 0));
+	storeWord(1, word, (readWord(1, word) & ~mask) | (disc == GC_PLAYER_TWO ? mask : 0));
+}
+
 bool Grid::insertDisc(unsigned int column, Cell disc){
 	// Empty disc can't be inserted
 	if(disc == GC_EMPTY){
@@ -30,40 +99,94 @@ bool Grid::insertDisc(unsigned int column, Cell disc){
 	else if(column > (noOfColumns - 1)){
 		return false;
 	}
-	else {
-		// find the row of the column (j) which is empty
-		int j = -1;
-		for(unsigned int i = 0; i < noOfRows; i++){
-			if(board[i][column] == GC_EMPTY){
-				j++;
-			}
-		}
-		// no empty rows
-		if(j == -1){
-			return false;
-		} else {
-			// inserting disc at (j) row and (column) column
-			board[j][column] = disc;
-			return true;
+	// no empty rows
+	else if(heights[column] == noOfRows){
+		return false;
+	} else {
+		// the disc lands on top of the discs already in the column
+		uint64_t bit = column * stride + heights[column];
+		if(cellAtBit(bit) == GC_EMPTY){
+			heights[column]++;
+			filled++;
 		}
+		setCellAtBit(bit, disc);
+		return true;
+	}
+}
+
+Grid::Cell Grid::removeDisc(unsigned int column){
+	if(column >= noOfColumns || heights[column] == 0){
+		return GC_EMPTY;
 	}
+	// the top disc of the column sits just below the first free cell
+	uint64_t bit = column * stride + heights[column] - 1;
+	Cell disc = cellAtBit(bit);
+	setCellAtBit(bit, GC_EMPTY);
+	heights[column]--;
+	filled--;
+	return disc;
 }
 
 Grid::Cell Grid::cellAt(unsigned int row, unsigned int column) const{
 	// Adjusting for boundaries
-	if(row > noOfRows){
+	if(row >= noOfRows){
 		return GC_EMPTY;
-	} else if (column > noOfColumns){
+	} else if (column >= noOfColumns){
 		return GC_EMPTY;
 	} else {
 		// Returning cell at particular row and column
-		return board[row][column];
+		return cellAtBit(bitIndex(row, column));
+	}
+}
+
+void Grid::copyRow(unsigned int row, std::vector<Cell>& cells) const{
+	cells.clear();
+	if(row >= noOfRows){
+		return;
+	}
+	// The row is one bit of every column, `stride` bits apart. A cell's bits in the two bitboards read as a 2-bit number
+	// are its Cell value, player one's bit being the low bit
+	cells.resize(noOfColumns);
+	uint64_t bit = bitIndex(row, 0);
+	for(unsigned int c = 0; c < noOfColumns; c++, bit += stride){
+		uint64_t word = bit >> 6;
+		unsigned int shift = bit & 63;
+		cells[c] = (Cell)(((readWord(0, word) >> shift) & 1) | (((readWord(1, word) >> shift) & 1) << 1));
+	}
+}
+
+void Grid::copyColumn(unsigned int column, std::vector<Cell>& cells) const{
+	cells.clear();
+	if(column >= noOfColumns){
+		return;
+	}
+	cells.resize(noOfRows, GC_EMPTY);
+	// Read the column from the bottom up, 64 cells at a time, stopping at the highest disc of each chunk
+	for(unsigned int start = 0; start < noOfRows; start += 64){
+		unsigned int count = std::min(64u, noOfRows - start);
+		uint64_t one = extractBits(0, column * stride + start, count);
+		uint64_t two = extractBits(1, column * stride + start, count);
+		Cell* cell = &cells[noOfRows - 1 - start];
+		for(; (one | two) != 0; one >>= 1, two >>= 1, cell--){
+			*cell = (Cell)((one & 1) | ((two & 1) << 1));
+		}
 	}
 }
 
 void Grid::reset(){
-	// Resetting all the rows and columns to empty by assign function
-	board.assign(noOfRows, std::vector<Cell>(noOfColumns, GC_EMPTY));
+	// Clearing both bitboards and all column heights. A sparse grid hands back the pages it allocated
+	if(sparse){
+		for(unsigned int i = 0; i < pages.size(); i++){
+			if(!pages[i].empty()){
+				std::vector<uint64_t>().swap(pages[i]);
+			}
+		}
+	} else {
+		bitboards.assign(2 * planeWords, 0);
+	}
+	heights.assign(noOfColumns, 0);
+	filled = 0;
+	gapColumns.clear();
 }
 
 unsigned int Grid::rowCount() const{
@@ -74,14 +197,79 @@ unsigned int Grid::columnCount() const{
 	return noOfColumns;
 }
 
+unsigned int Grid::columnHeight(unsigned int column) const{
+	if(column >= noOfColumns){
+		return 0;
+	}
+	return heights[column];
+}
+
+bool Grid::isColumnFull(unsigned int column) const{
+	if(column >= noOfColumns){
+		return true;
+	}
+	return heights[column] == noOfRows;
+}
+
+unsigned int Grid::discCount() const{
+	return filled;
+}
+
+bool Grid::isSparse() const{
+	return sparse;
+}
+
+bool Grid::sameDiscs(const Grid& other) const{
+	if(noOfRows != other.noOfRows || noOfColumns != other.noOfColumns || filled != other.filled
+		|| heights != other.heights){
+		return false;
+	}
+	if(!sparse){
+		return bitboards == other.bitboards;
+	}
+	// Pages may have been allocated on one grid and not the other, so compare what they read as
+	for(uint64_t i = 0; i < words; i++){
+		if(readWord(0, i) != other.readWord(0, i) || readWord(1, i) != other.readWord(1, i)){
+			return false;
+		}
+	}
+	return true;
+}
+
+
+uint64_t Grid::bitboard(Cell disc) const{
+	if(disc == GC_EMPTY || words != 1){
+		return 0;
+	}
+	return bitboards[disc == GC_PLAYER_ONE ? 0 : 1];
+}
+
+bool Grid::setBitboards(uint64_t one, uint64_t two){
+	if(words != 1){
+		return false;
+	}
+	bitboards[0] = one;
+	bitboards[1] = two;
+	gapColumns.clear();
+	// the discs of each column are stacked from the bottom, so its height is its disc count
+	uint64_t column = ((uint64_t)1 << noOfRows) - 1;
+	filled = 0;
+	for(unsigned int c = 0; c < noOfColumns; c++){
+		heights[c] = countBits(((one | two) >> (c * stride)) & column);
+		filled += heights[c];
+	}
+	return true;
+}
 
 void Grid::printBoard(){
 	// Used for debugging. Prints out the grid for you
 	cout << "*******************" << endl;
 
-	for(int i = 0; i < noOfRows; i++){
-		for(int j = 0; j< noOfColumns; j++){
-			cout << board[i][j];
+	std::vector<Cell> row;
+	for(unsigned int i = 0; i < noOfRows; i++){
+		copyRow(i, row);
+		for(unsigned int j = 0; j< noOfColumns; j++){
+			cout << row[j];
 		}
 		cout << endl;
 	}
@@ -91,70 +279,266 @@ void Grid::printBoard(){
 
 void Grid::makeEmptyCell(int x, int y){
 	// Making a particular cell empty
-	board[y][x] = GC_EMPTY;
-}
-
-bool Grid::noMoreMoves(){
-	// To find if any more moves can be made in the meaning if the grid is full hence the game is tie
-	// find the row of the column (j) which is empty
-	unsigned int k;
-	for(k = 0; k < noOfColumns; k++){
-		int j = -1;
-		for(unsigned int i = 0; i < noOfRows; i++){
-			if(board[i][k] == GC_EMPTY){
-				j++;
+	uint64_t bit = bitIndex(y, x);
+	if(cellAtBit(bit) != GC_EMPTY){
+		heights[x]--;
+		filled--;
+		setCellAtBit(bit, GC_EMPTY);
+		gapColumns.push_back(x);
+	}
+}
+
+bool Grid::noMoreMoves() const{
+	// The grid is full (and hence the game is tie) once every cell holds a disc
+	return filled == (uint64_t)noOfRows * noOfColumns;
+}
+
+void Grid::fallDown(){
+	std::vector<std::pair<unsigned int, unsigned int> > moved;
+	fallDown(moved);
+}
+
+void Grid::fallDown(std::vector<std::pair<unsigned int, unsigned int> >& moved){
+	// Method for all the cells to fall down when a combo is disappeared. Only columns a cell has been emptied in can have
+	// gaps, and they're visited from left to right
+	std::sort(gapColumns.begin(), gapColumns.end());
+	gapColumns.erase(std::unique(gapColumns.begin(), gapColumns.end()), gapColumns.end());
+	for(unsigned int k = 0; k < gapColumns.size(); k++){
+		unsigned int l = gapColumns[k];
+		// Find the lowest gap in the column, reading up to 64 cells at a time
+		uint64_t base = (uint64_t)l * stride;
+		unsigned int height = heights[l];
+		unsigned int gap = 0;
+		while(gap < height){
+			unsigned int count = std::min(64u, noOfRows - gap);
+			uint64_t occupied = extractBits(0, base + gap, count) | extractBits(1, base + gap, count);
+			// the low bits of occupied ^ (occupied + 1) are the run of occupied cells, plus the gap above it
+			unsigned int run = ~occupied == 0 ? 64 : countBits(occupied ^ (occupied + 1)) - 1;
+			gap += run;
+			if(run < count){
+				break;
 			}
 		}
-		// If (j) equals to -1 means no row is empty
-		// hence if (j) does not equal to -1 for any column means there is still moves left
-		if(j != -1){
-			return false;
+		if(gap >= height){
+			continue;	// no gaps below the top disc, nothing falls
+		}
+
+		// Gather both players' discs down past the gaps, a chunk at a time, using the occupied cells as the selection
+		// mask so the discs keep their order. Reading always stays ahead of writing, so no disc is overwritten before
+		// it's read.
+		unsigned int read = gap;
+		unsigned int write = gap;
+		while(write < height){
+			unsigned int count = std::min(64u, noOfRows - read);
+			uint64_t one = extractBits(0, base + read, count);
+			uint64_t two = extractBits(1, base + read, count);
+			uint64_t occupied = one | two;
+			unsigned int discs = countBits(occupied);
+			if(discs > 0){
+				depositBits(0, base + write, discs, gatherBits(one, occupied));
+				depositBits(1, base + write, discs, gatherBits(two, occupied));
+			}
+			write += discs;
+			read += count;
+		}
+		// Everything between the new top of the column and the last cell read has been moved down
+		for(unsigned int i = height; i < read; i += 64){
+			unsigned int count = std::min(64u, read - i);
+			depositBits(0, base + i, count, 0);
+			depositBits(1, base + i, count, 0);
+		}
+		for(unsigned int i = gap; i < height; i++){
+			moved.push_back(std::make_pair(noOfRows - 1 - i, l));
 		}
 	}
-	// if (k) column is the last column and there was no empty row since we checked at every column then return true
-	if(k == noOfColumns - 1){
-		return true;
+	gapColumns.clear();
+}
+
+unsigned int Grid::countBits(uint64_t bits){
+	// Add up neighbouring bits in pairs, then nibbles, then bytes
+	bits = bits - ((bits >> 1) & 0x5555555555555555ULL);
+	bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+	bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (bits * 0x0101010101010101ULL) >> 56;
+}
+
+uint64_t Grid::gatherBits(uint64_t bits, uint64_t mask){
+#ifdef __BMI2__
+	return _pext_u64(bits, mask);
+#else
+	// Walk the set bits of the mask from the bottom, packing the matching bits of `bits` together
+	uint64_t result = 0;
+	for(uint64_t out = 1; mask != 0; out <<= 1){
+		uint64_t lowest = mask & (~mask + 1);
+		if(bits & lowest){
+			result |= out;
+		}
+		mask ^= lowest;
 	}
+	return result;
+#endif
 }
 
-void Grid::fallDown(){
-	// Method for all the cells to fall down when a combo is disappeared
-	for(unsigned int l = 0 ; l < noOfColumns; l++){
-		// Running a loop through all columns and finding the first row which is not empty
-		int j = -1;
-		int noOfBreaks = 0;
-		std::vector<int> breakIndexes;
-		for(unsigned int i = 0; i < noOfRows; i++){
-			if(board[i][l] == GC_EMPTY){
-				j++;
-			} else {
-				break;
-			}
+void Grid::depositBits(unsigned int player, uint64_t start, unsigned int count, uint64_t bits){
+	// Overwrite `count` bits (at most 64) starting at bit `start`, which may straddle two words
+	uint64_t field = count < 64 ? ((uint64_t)1 << count) - 1 : ~(uint64_t)0;
+	uint64_t word = start >> 6;
+	unsigned int shift = start & 63;
+	bits &= field;
+	storeWord(player, word, (readWord(player, word) & ~(field << shift)) | (bits << shift));
+	if(shift != 0 && shift + count > 64){
+		storeWord(player, word + 1, (readWord(player, word + 1) & ~(field >> (64 - shift))) | (bits >> (64 - shift)));
+	}
+}
+
+uint64_t Grid::extractBits(unsigned int player, uint64_t start, unsigned int count) const{
+	uint64_t word = start >> 6;
+	unsigned int shift = start & 63;
+	uint64_t result = readWord(player, word) >> shift;
+	if(shift != 0 && word + 1 < words){
+		result |= readWord(player, word + 1) << (64 - shift);
+	}
+	if(count < 64){
+		result &= ((uint64_t)1 << count) - 1;
+	}
+	return result;
+}
+
+// Shift right by `amount` bits, giving 0 rather than undefined behaviour once every bit has been shifted out
+static inline uint64_t shiftDown(uint64_t bits, unsigned int amount){
+	return amount < 64 ? bits >> amount : 0;
+}
+
+// Mark the lowest bit of every run of `length` consecutive set bits, each `step` apart. Each shift and AND doubles the
+// run length covered while that stays within `length`, and one overlapping shift covers the rest, so a run of length K
+// costs about log2(K) shifts rather than K
+static inline uint64_t runStarts(uint64_t bits, unsigned int length, unsigned int step){
+	unsigned int covered = 1;
+	while(covered * 2 <= length){
+		bits &= shiftDown(bits, covered * step);
+		covered *= 2;
+	}
+	if(covered < length){
+		bits &= shiftDown(bits, (length - covered) * step);
+	}
+	return bits;
+}
+
+// Extend every bit of `mask` to the `count` bits below it, each `step` apart, doubling the same way
+static inline uint64_t spreadDown(uint64_t mask, unsigned int count, unsigned int step){
+	unsigned int covered = 1;
+	while(covered * 2 <= count + 1){
+		mask |= shiftDown(mask, covered * step);
+		covered *= 2;
+	}
+	if(covered < count + 1){
+		mask |= shiftDown(mask, (count + 1 - covered) * step);
+	}
+	return mask;
+}
+
+// Return true if `bits` holds `length` in a row through bit `cell`, for a board whose columns are `stride` bits apart
+static inline bool hasLineThrough(uint64_t bits, unsigned int cell, unsigned int stride, unsigned int length){
+	uint64_t steps[4] = { 1, stride, stride - 1, stride + 1 };	// vertical, horizontal and both diagonals
+	uint64_t mask = (uint64_t)1 << cell;
+	for(unsigned int i = 0; i < 4; i++){
+		// A line through the cell must start at most (length - 1) steps before it
+		unsigned int step = steps[i];
+		if(runStarts(bits, length, step) & spreadDown(mask, length - 1, step)){
+			return true;
 		}
-		if(j == noOfRows - 1){	// for empty columns do nothing
+	}
+	return false;
+}
 
-		} else {
-			j++;				// index of row of first disc
+// Same as above, passing the common lengths as constants so the shifts and loops above fold away when inlined
+static bool hasLineThroughAny(uint64_t bits, unsigned int cell, unsigned int stride, unsigned int length){
+	switch(length){
+	case 3:
+		return hasLineThrough(bits, cell, stride, 3);
+	case 4:
+		return hasLineThrough(bits, cell, stride, 4);
+	case 5:
+		return hasLineThrough(bits, cell, stride, 5);
+	case 6:
+		return hasLineThrough(bits, cell, stride, 6);
+	default:
+		return hasLineThrough(bits, cell, stride, length);
+	}
+}
 
-			for(int i = j; i < noOfRows; i++){
-				if(board[i][l] == GC_EMPTY){
-					// If there are empty spaces after the first non-empty row, store the indexes of the empty spaces in a vector
-					breakIndexes.push_back(i);
-					noOfBreaks++;
-				}
+bool Grid::connectsFour(unsigned int row, unsigned int column, Cell disc) const{
+	return connectsLine(row, column, disc, 4);
+}
+
+bool Grid::connectsLine(unsigned int row, unsigned int column, Cell disc, unsigned int length) const{
+	if(disc == GC_EMPTY || row >= noOfRows || column >= noOfColumns || length > MAX_LINE_LENGTH){
+		return false;
+	}
+	if(length < 1){
+		length = 1;
+	}
+	unsigned int player = (disc == GC_PLAYER_ONE) ? 0 : 1;
+	if(words == 1){
+		// The whole board is a single word, test it in place
+		return hasLineThroughAny(bitboards[player], bitIndex(row, column), stride, length);
+	}
+	int height = noOfRows - 1 - row;
+	if(length <= 4){
+		// Copy the 7x7 neighbourhood of the cell into one word, 8 bits per column so the top bit stays clear
+		int lowest = (height < 3) ? 0 : height - 3;
+		int highest = (height + 3 > (int)noOfRows - 1) ? noOfRows - 1 : height + 3;
+		uint64_t window = 0;
+		for(int i = 0; i < 7; i++){
+			int c = (int)column - 3 + i;
+			if(c < 0 || c >= (int)noOfColumns){
+				continue;
+			}
+			uint64_t bits = extractBits(player, c * stride + lowest, highest - lowest + 1);
+			window |= bits << (8 * i + lowest - (height - 3));
+		}
+		return hasLineThroughAny(window, 3 * 8 + 3, 8, length);
+	}
+	// Longer lines don't fit a square window in one word. The cell's column is read once, (length - 1) cells either
+	// side of the cell, to check the cell holds the disc and test for a vertical run. The other lines are followed out
+	// from the cell a column at a time, reading the cells each of them passes through in that column together, until
+	// every line has met a gap or the edge of the grid on that side. Runs on a board in play are short, so this usually
+	// stops within a column or two, whatever the length
+	int reach = length - 1;
+	int lowest = (height < reach) ? 0 : height - reach;
+	int highest = (height + reach > (int)noOfRows - 1) ? noOfRows - 1 : height + reach;
+	uint64_t own = extractBits(player, column * stride + lowest, highest - lowest + 1) << (lowest - (height - reach));
+	if(((own >> reach) & 1) == 0){
+		return false;
+	}
+	if(runStarts(own, length, 1) != 0){
+		return true;
+	}
+	unsigned int runs[3] = { 1, 1, 1 };	// horizontal, rising and falling, counting the cell itself
+	for(int side = -1; side <= 1; side += 2){
+		bool open[3] = { true, true, true };
+		for(int d = 1; d <= reach && (open[0] || open[1] || open[2]); d++){
+			int c = (int)column + side * d;
+			if(c < 0 || c >= (int)noOfColumns){
+				break;
 			}
-			if(noOfBreaks > 0){	// if there are breaks in columns
-				for(int i = 0; i < noOfBreaks; i++){
-					int k = breakIndexes[i];
-					for(k ; k > j; k-- ){
-						// start from the first break and keep moving 1 index down until where the first non-empty row was
-						board[k][l] = board[k - 1][l];
-					}
-					// make the last row as empty as all the cells are moved downwards
-					board[k][l] = GC_EMPTY;
+			// bit b of `bits` is height (height - d + b), so the three lines pass through bits d - side * d, d and
+			// d + side * d
+			int low = (height < d) ? 0 : height - d;
+			int high = (height + d > (int)noOfRows - 1) ? noOfRows - 1 : height + d;
+			uint64_t bits = extractBits(player, c * stride + low, high - low + 1) << (low - (height - d));
+			unsigned int at[3] = { (unsigned int)d, (unsigned int)(d + side * d), (unsigned int)(d - side * d) };
+			for(unsigned int i = 0; i < 3; i++){
+				if(!open[i]){
+					continue;
+				}
+				if(((bits >> at[i]) & 1) == 0){
+					open[i] = false;
+				} else if(++runs[i] >= length){
+					return true;
 				}
 			}
 		}
 	}
+	return false;
 }
-
@@ -2,6 +2,10 @@
 #define GRID_HPP
 #include <iostream>
 #include <vector>
+#include <utility>
+#include <stdint.h>
+#include <cstddef>
+#include <new>
 
 using namespace std;
 /*
@@ -15,6 +19,29 @@ grid where players insert discs is row 0, while the bottom row of the Grid is ro
 
 Each cell of the grid will be represented by the Cell enum. Each cell can be either empty or occupied by a disc owned by
 one of the two players currently playing.
+
+Internally the Grid is stored as one bitboard per player. Each column occupies (rows + 1) consecutive bits, starting
+from the bottom row, with the extra bit on top of every column always left clear so that shifting a bitboard never
+carries a disc from one column into the next. Boards with (rows + 1) * columns <= 64 fit into a single 64-bit word per
+player; larger boards spill over into as many words as needed. Their columns are padded with clear bits up to a power of
+two of at most 64 bits, or a whole number of words, so that a column never straddles two words: reading a column of up
+to 64 cells, or the next 64 cells of a taller one, always takes a single word. A per-column height array records how
+many discs each column holds and a running total records how many cells are filled, so finding where a disc lands,
+whether a column is full and whether the whole grid is full are all constant-time.
+
+Both bitboards live in one contiguous buffer, so a grid takes a little over 2 bits per cell whatever its size: about
+256 KB for 1000x1000, in a single allocation that `reset` clears a word at a time without reallocating it. The buffer
+and each player's half of it start on a cache line, so a padded column of up to 511 cells sits in a single line of
+each bitboard, and one of up to 1023 cells in two.
+
+Grids too large for that to be reasonable (more than SPARSE_WORDS words per player, about 4 million cells) are sparse:
+their bitboards are split into pages of PAGE_WORDS words per player that are only allocated once a disc is written to
+them, so a huge grid that is mostly empty costs memory for the pages that hold discs rather than two bits per cell.
+Reading a page that was never written gives empty cells, so a sparse grid behaves exactly like any other. The page
+directory and the per-column heights are still allocated up front, though, so even an empty sparse grid takes memory
+growing with its area: 24 bytes per page (one page per 4096 bits) plus 4 bytes per column, about 50 MB for a
+1000x5000000 grid. Either way, `fallDown` only looks at the columns that `makeEmptyCell` has opened gaps in since it
+last ran.
 */
 class Grid {
 
@@ -52,12 +79,30 @@ public:
     */
     bool insertDisc(unsigned int column, Cell disc);
 
+    /*
+    Remove the top disc of the specified column, undoing the `insertDisc` that put it there. Returns the disc removed,
+    or GC_EMPTY (changing nothing) if the column is empty or outside the bounds of the grid. This takes constant time.
+    */
+    Cell removeDisc(unsigned int column);
+
     /*
     Get the value of the cell at the specified row and column of the Grid. Returns GC_EMPTY if `row` or `column` are
     outside the bounds of the grid.
     */
     Cell cellAt(unsigned int row, unsigned int column) const;
 
+    /*
+    Replace the contents of `cells` with the cells of the specified row, from column 0 to the right. Leaves `cells`
+    empty if the row is outside the bounds of the grid.
+    */
+    void copyRow(unsigned int row, std::vector<Cell>& cells) const;
+
+    /*
+    Replace the contents of `cells` with the cells of the specified column, from row 0 (the top) down. The column's bits
+    are read up to 64 cells at a time. Leaves `cells` empty if the column is outside the bounds of the grid.
+    */
+    void copyColumn(unsigned int column, std::vector<Cell>& cells) const;
+
     /*
     Reset the state of the Grid, removing all player discs and setting the state of all cells to GC_EMPTY.
     */
@@ -72,6 +117,34 @@ public:
     */
     unsigned int columnCount() const;
 
+    /*
+    Return the number of discs currently held by the specified column, or 0 if the column is outside the bounds of the
+    grid. Immediately after a disc is inserted into a column, that disc sits in row (rowCount() - columnHeight(column)).
+    */
+    unsigned int columnHeight(unsigned int column) const;
+
+    /*
+    Return `true` if the specified column has no space left for another disc. Columns outside the bounds of the grid are
+    reported as full.
+    */
+    bool isColumnFull(unsigned int column) const;
+
+    /*
+    Return the total number of discs currently in the grid.
+    */
+    unsigned int discCount() const;
+
+    /*
+    Return `true` if the grid keeps its bitboards in pages allocated as they are written (see above).
+    */
+    bool isSparse() const;
+
+    /*
+    Return `true` if the other grid has the same dimensions and holds the same disc in every cell. Compares whole words
+    of the bitboards at a time.
+    */
+    bool sameDiscs(const Grid& other) const;
+
     // Make the particular cell empty
 
     void makeEmptyCell(int x, int y);
@@ -79,16 +152,133 @@ public:
     // Prints the grid used for debugging purposes
     void printBoard();
 
-    // The cells are dropped down when connect 4 disappears in supergame
+    // The cells are dropped down when connect 4 disappears in supergame. Columns without gaps are skipped, and the
+    // rest are packed down up to 64 cells at a time
     void fallDown();
 
+    // Same as above, also appending the (row, column) each disc that moved has landed on to `moved`
+    void fallDown(std::vector<std::pair<unsigned int, unsigned int> >& moved);
+
     // When there's no more moves left and hence leads to a tie
-    bool noMoreMoves();
+    bool noMoreMoves() const;
+
+    /*
+    Return `true` if the discs of the given player form four in a row (horizontally, vertically or diagonally) through
+    the cell at (row, column). This is `connectsLine` with a length of 4: a fixed number of shift and AND operations on
+    the player's bitboard, directly for boards that fit into a single 64-bit word, and on a 7x7 window around the cell
+    otherwise. Returns `false` for GC_EMPTY or a cell outside the bounds of the grid.
+    */
+    bool connectsFour(unsigned int row, unsigned int column, Cell disc) const;
+
+    /*
+    The longest line `connectsLine` can look for.
+    */
+    static const unsigned int MAX_LINE_LENGTH = 32;
+
+    /*
+    Return `true` if the discs of the given player form `length` in a row (horizontally, vertically or diagonally)
+    through the cell at (row, column). Boards that fit into a single 64-bit word, and lines of up to 4 on a 7x7 window
+    around the cell otherwise, are tested by repeatedly ANDing the bitboard with itself shifted along the line, doubling
+    the run length covered each time, so their cost grows with log2(length). Longer lines on larger boards are followed
+    out from the cell a column at a time until each meets a gap, so their cost follows the runs actually on the board
+    around the cell (at most `length - 1` columns either side) rather than `length`. Returns `false` for GC_EMPTY, a
+    cell outside the bounds of the grid or a length above MAX_LINE_LENGTH.
+    */
+    bool connectsLine(unsigned int row, unsigned int column, Cell disc, unsigned int length) const;
+
+    /*
+    For grids that fit into a single 64-bit word per player ((rows + 1) * columns <= 64), return the bitboard of the
+    given player's discs, in the layout described above. Returns 0 for GC_EMPTY or a larger grid.
+    */
+    uint64_t bitboard(Cell disc) const;
+
+    /*
+    For grids that fit into a single 64-bit word per player, replace every disc of the grid with the discs of the two
+    bitboards, in the layout described above. The bitboards must not overlap or set any bit outside the grid, and each
+    column's discs must be stacked from the bottom without gaps. Returns `false`, changing nothing, for a larger grid.
+    */
+    bool setBitboards(uint64_t one, uint64_t two);
+
+    /*
+    Pack the bits of `bits` selected by `mask` into the low bits of the result, keeping their order. Uses the BMI2 PEXT
+    instruction when the compiler targets it (e.g. -mbmi2 or -march=native), and a loop over the mask otherwise.
+    */
+    static uint64_t gatherBits(uint64_t bits, uint64_t mask);
+
+    /*
+    Return the number of set bits in `bits`.
+    */
+    static unsigned int countBits(uint64_t bits);
 
 private:
+    // Bytes and words in a cache line
+    static const unsigned int LINE_BYTES = 64;
+    static const unsigned int LINE_WORDS = LINE_BYTES / 8;
+
+    // Allocates the bitboards on cache line boundaries
+    template <class T>
+    struct LineAllocator {
+        typedef T value_type;
+        LineAllocator() {}
+        template <class U> LineAllocator(const LineAllocator<U>&) {}
+#if __cpp_aligned_new
+        T* allocate(std::size_t count) {
+            return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(LINE_BYTES)));
+        }
+        void deallocate(T* block, std::size_t) { ::operator delete(block, std::align_val_t(LINE_BYTES)); }
+#else
+        // Without aligned allocation the buffer is only as aligned as the heap makes it
+        T* allocate(std::size_t count) { return static_cast<T*>(::operator new(count * sizeof(T))); }
+        void deallocate(T* block, std::size_t) { ::operator delete(block); }
+#endif
+        bool operator==(const LineAllocator&) const { return true; }
+        bool operator!=(const LineAllocator&) const { return false; }
+    };
+
+    // Words per player above which a grid is sparse
+    static const unsigned int SPARSE_WORDS = 1 << 16;
+
+    // Words of each player's bitboard held by one page of a sparse grid
+    static const unsigned int PAGE_WORDS = 64;
+
+    // Word `index` of a player's bitboard (0 or 1). Pages of a sparse grid that were never written read as 0
+    uint64_t readWord(unsigned int player, uint64_t index) const;
+
+    // Store word `index` of a player's bitboard, allocating its page first if the grid is sparse and the value isn't 0
+    void storeWord(unsigned int player, uint64_t index, uint64_t value);
+
+    // Index of the bit representing the cell at (row, column) within each player's bitboard. Bit and word indices are
+    // 64-bit, as a grid can hold more than 2^32 bits
+    uint64_t bitIndex(unsigned int row, unsigned int column) const;
+
+    // Value of the cell stored at the given bit index
+    Cell cellAtBit(uint64_t bit) const;
+
+    // Store a cell value at the given bit index, clearing whatever was there before
+    void setCellAtBit(uint64_t bit, Cell disc);
+
+    // Read `count` (at most 64) bits of a player's bitboard (0 or 1) starting at bit `start`
+    uint64_t extractBits(unsigned int player, uint64_t start, unsigned int count) const;
+
+    // Write the low `count` (at most 64) bits of `bits` into a player's bitboard starting at bit `start`
+    void depositBits(unsigned int player, uint64_t start, unsigned int count, uint64_t bits);
+
     unsigned int noOfRows;
     unsigned int noOfColumns;
-    std::vector< std::vector<Cell> > board;
+    uint64_t stride;    // bits per column (rows + 1, the top bit being an always-empty separator, plus any padding)
+    uint64_t words;     // 64-bit words per player bitboard
+    uint64_t planeWords;    // distance between the start of the two bitboards, in words
+    bool sparse;
+    // Player one's bitboard in words [0, words), player two's in [planeWords, planeWords + words), or empty if sparse
+    std::vector<uint64_t, LineAllocator<uint64_t> > bitboards;
+    // For a sparse grid, the pages of PAGE_WORDS words of player one then PAGE_WORDS of player two, empty until written
+    std::vector<std::vector<uint64_t> > pages;
+    // Columns that may have had a gap opened in them since the last fallDown
+    std::vector<unsigned int> gapColumns;
+    // Number of discs currently held by each column
+    std::vector<unsigned int> heights;
+    // Number of discs currently held by the whole grid
+    unsigned int filled;
 };
 
 #endif /* end of include guard: GRID_HPP */
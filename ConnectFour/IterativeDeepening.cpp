@@ -0,0 +1,259 @@
+#include "IterativeDeepening.hpp"
+#include <memory>
+
+IterativeDeepening::IterativeDeepening() : standInOne("Stand-in One"), standInTwo("Stand-in Two"){
+	depthLimit = 8;
+	aspiration = 32;
+	mover = 0;
+	undo = true;
+	length = 4;
+	followingLine = false;
+	nodes = 0;
+	stopped = false;
+	rootAlpha = 0;
+	rootBest = 0;
+	rootColumn = -1;
+}
+
+void IterativeDeepening::setDepthLimit(unsigned int depth){
+	depthLimit = depth;
+}
+
+void IterativeDeepening::setAspirationWindow(int width){
+	aspiration = width < 0 ? 0 : width;
+}
+
+int IterativeDeepening::linesPlayed(const Grid& grid, unsigned int row, unsigned int column) const{
+	Grid::Cell disc = grid.cellAt(row, column);
+	if(disc == Grid::GC_EMPTY){
+		return 0;	// cleared straight away in a SuperGame
+	}
+	static const int directions[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+	const int span = length - 1;
+	const int rows = grid.rowCount();
+	const int columns = grid.columnCount();
+	int change = 0;
+	for(unsigned int d = 0; d < 4; d++){
+		// The cells from `span` before the disc to `span` after it: 0 for empty, 1 for the disc's player, 2 for the
+		// other player and 3 outside the grid
+		unsigned char cells[2 * Grid::MAX_LINE_LENGTH];
+		for(int k = -span; k <= span; k++){
+			int r = (int)row + k * directions[d][0];
+			int c = (int)column + k * directions[d][1];
+			if(r < 0 || r >= rows || c < 0 || c >= columns){
+				cells[k + span] = 3;
+				continue;
+			}
+			Grid::Cell cell = grid.cellAt(r, c);
+			cells[k + span] = cell == Grid::GC_EMPTY ? 0 : cell == disc ? 1 : 2;
+		}
+		// Slide a window of `length` cells along, every window holding the disc
+		unsigned int counts[4] = { 0, 0, 0, 0 };
+		for(unsigned int k = 0; k + 1 < length; k++){
+			counts[cells[k]]++;
+		}
+		for(unsigned int k = length - 1; k < 2 * length - 1; k++){
+			counts[cells[k]]++;
+			if(counts[3] == 0){
+				if(counts[2] == 0){
+					// one more disc in a line of the player's own: n * n - (n - 1) * (n - 1)
+					change += 2 * counts[1] - 1;
+				} else if(counts[1] == 1){
+					// the other player's line is blocked
+					change += counts[2] * counts[2];
+				}
+			}
+			counts[cells[k + 1 - length]]--;
+		}
+	}
+	return change;
+}
+
+int IterativeDeepening::searchMove(Game& game, unsigned int column, unsigned int depth, int alpha, int beta,
+								   unsigned int ply, int estimate){
+	unsigned int row = game.grid()->rowCount() - 1 - game.grid()->columnHeight(column);
+	if(!undo){
+		// Every copy is played by the same stand-ins, so their scores are put back once the copy is done with
+		unsigned int scores[2] = { standInOne.getScore(), standInTwo.getScore() };
+		std::unique_ptr<Game> child(game.clone());
+		child->playNextTurn(column);
+		int played = linesPlayed(*child->grid(), row, column);
+		int score = -negamax(*child, depth, -beta, -alpha, ply + 1, -(estimate + played));
+		standInOne.setScore(scores[0]);
+		standInTwo.setScore(scores[1]);
+		return score;
+	}
+	game.playNextTurn(column);
+	int played = linesPlayed(*game.grid(), row, column);
+	int score = -negamax(game, depth, -beta, -alpha, ply + 1, -(estimate + played));
+	game.undoMove();
+	return score;
+}
+
+int IterativeDeepening::negamax(Game& game, unsigned int depth, int alpha, int beta, unsigned int ply, int estimate){
+	nodes++;
+	if((nodes & 255) == 0 && clock.pastHardLimit()){
+		stopped = true;
+	}
+	if(stopped){
+		return 0;	// the result is thrown away, so any value will do
+	}
+	lineLengths[ply] = ply;
+	if(game.status() != Game::GS_IN_PROGRESS){
+		const Player* winner = game.winner();
+		if(winner == 0){
+			return 0;
+		}
+		// The player to move at the root is to move again after an even number of moves
+		bool won = (winner == mover) == (ply % 2 == 0);
+		return won ? WIN_SCORE - (int)ply : -(WIN_SCORE - (int)ply);
+	}
+	if(depth == 0){
+		bool oneToMove = (mover == &standInOne) == (ply % 2 == 0);
+		int difference = (int)game.score(Grid::GC_PLAYER_ONE) - (int)game.score(Grid::GC_PLAYER_TWO);
+		return estimate + SCORE_WEIGHT * (oneToMove ? difference : -difference);
+	}
+
+	// The last iteration's move comes first while the moves so far follow its line, then the rest from the centre out
+	const Grid& grid = *game.grid();
+	bool onLine = followingLine && ply < previousLine.size();
+	followingLine = onLine;
+	unsigned int first = onLine ? previousLine[ply] : columnOrder[0];
+	const unsigned int width = MAX_DEPTH + 1;
+	int best = -INFINITE_SCORE;
+	for(unsigned int i = 0; i <= columnOrder.size(); i++){
+		unsigned int column = i == 0 ? first : columnOrder[i - 1];
+		if((i > 0 && column == first) || grid.isColumnFull(column)){
+			continue;
+		}
+		int score = searchMove(game, column, depth - 1, alpha, beta, ply, estimate);
+		followingLine = false;
+		if(stopped){
+			return 0;
+		}
+		if(score > best){
+			best = score;
+			lines[ply * width + ply] = column;
+			for(unsigned int k = ply + 1; k < lineLengths[ply + 1]; k++){
+				lines[ply * width + k] = lines[(ply + 1) * width + k];
+			}
+			lineLengths[ply] = lineLengths[ply + 1] > ply + 1 ? lineLengths[ply + 1] : ply + 1;
+			if(ply == 0){
+				rootBest = score;
+				rootColumn = column;
+			}
+		}
+		if(best > alpha){
+			alpha = best;
+		}
+		if(alpha >= beta){
+			break;
+		}
+	}
+	return best;
+}
+
+IterativeDeepening::Result IterativeDeepening::search(const Game& game){
+	Result result;
+	result.column = -1;
+	result.score = 0;
+	result.depth = 0;
+	result.interrupted = false;
+	result.nodes = 0;
+	result.researches = 0;
+	const Grid* grid = game.grid();
+	unsigned int empty = grid == 0 ? 0 : grid->rowCount() * grid->columnCount() - grid->discCount();
+	clock.start((empty + 1) / 2);
+	if(game.status() != Game::GS_IN_PROGRESS){
+		result.milliseconds = clock.elapsed();
+		return result;
+	}
+
+	// Copies share the game's players, so hand the copy to the stand-ins, starting from the game's scores, before
+	// anything is played on it
+	std::unique_ptr<Game> root(game.clone());
+	standInOne.setScore(game.score(Grid::GC_PLAYER_ONE));
+	standInTwo.setScore(game.score(Grid::GC_PLAYER_TWO));
+	root->setPlayerOne(&standInOne);
+	root->setPlayerTwo(&standInTwo);
+	mover = root->nextPlayer();
+	undo = root->supportsUndo();
+	length = root->winLength();
+	unsigned int columns = grid->columnCount();
+	columnOrder.resize(columns);
+	for(unsigned int i = 0; i < columns; i++){
+		// Start in the middle and work outwards, alternating left and right
+		int offset = (i % 2 == 0) ? (int)(i + 1) / 2 : -(int)(i + 1) / 2;
+		columnOrder[i] = columns / 2 + offset;
+	}
+	lines.assign((MAX_DEPTH + 1) * (MAX_DEPTH + 1), 0);
+	lineLengths.assign(MAX_DEPTH + 1, 0);
+	previousLine.clear();
+	nodes = 0;
+	stopped = false;
+
+	// Until an iteration finishes, the most central playable column will do
+	for(unsigned int i = 0; i < columns && result.column == -1; i++){
+		if(!grid->isColumnFull(columnOrder[i])){
+			result.column = columnOrder[i];
+		}
+	}
+	unsigned int maxDepth = depthLimit == 0 || depthLimit > MAX_DEPTH ? MAX_DEPTH : depthLimit;
+	maxDepth = maxDepth > empty ? empty : maxDepth;
+	const int decisive = WIN_SCORE - (int)MAX_DEPTH;
+	for(unsigned int depth = 1; depth <= maxDepth; depth++){
+		if(depth > 1 && clock.pastSoftLimit()){
+			break;
+		}
+		int alpha = -INFINITE_SCORE;
+		int beta = INFINITE_SCORE;
+		int window = aspiration;
+		if(depth > 1 && window > 0){
+			alpha = result.score - window;
+			beta = result.score + window;
+		}
+		int score;
+		while(true){
+			rootAlpha = alpha;
+			rootBest = -INFINITE_SCORE;
+			rootColumn = -1;
+			followingLine = true;
+			score = negamax(*root, depth, alpha, beta, 0, 0);
+			if(stopped){
+				break;
+			}
+			window = window < WIN_SCORE ? window * 4 : window;
+			if(score <= alpha && alpha > -INFINITE_SCORE){
+				// fail low: the score is at most `score`, so look further down
+				alpha = window < WIN_SCORE ? score - window : -INFINITE_SCORE;
+				alpha = alpha < -INFINITE_SCORE ? -INFINITE_SCORE : alpha;
+			} else if(score >= beta && beta < INFINITE_SCORE){
+				beta = window < WIN_SCORE ? score + window : INFINITE_SCORE;
+				beta = beta > INFINITE_SCORE ? INFINITE_SCORE : beta;
+			} else {
+				break;
+			}
+			result.researches++;
+		}
+		if(stopped){
+			// A move of the interrupted iteration that beat the window's lower bound is known to be better
+			result.interrupted = true;
+			if(rootColumn >= 0 && rootBest > rootAlpha){
+				result.column = rootColumn;
+			}
+			break;
+		}
+		result.column = lines[0];
+		result.score = score;
+		result.depth = depth;
+		result.line.assign(lines.begin(), lines.begin() + lineLengths[0]);
+		previousLine = result.line;
+		if(score >= decisive || score <= -decisive){
+			// a forced win or loss doesn't change with depth
+			break;
+		}
+	}
+	result.nodes = nodes;
+	result.milliseconds = clock.elapsed();
+	return result;
+}
@@ -0,0 +1,136 @@
+#ifndef ITERATIVEDEEPENING_HPP
+#define ITERATIVEDEEPENING_HPP
+
+#include "Game.hpp"
+#include "Player.hpp"
+#include "TimeManager.hpp"
+#include <vector>
+
+/*
+IterativeDeepening chooses moves by a depth-limited alpha-beta search, repeated one ply deeper at a time until a depth
+limit or a deadline is reached, so it always has a move ready and can be stopped at any moment. It works on any Game or
+SuperGame of any grid size, relying only on `Game::playNextTurn`, `Game::status` and the Grid, which makes it the
+engine to use under a deadline where the Solver can't help or can't finish in time.
+
+Positions at the depth limit are scored by counting lines: every line of `winLength` cells through the grid that holds
+discs of only one player scores the square of its number of discs, for that player. The score is kept up to date from
+the lines through each disc as it is played rather than recounted, so scoring a position takes no longer on a
+1000x1000 grid than on a 6x7 one. In a SuperGame, where combos cleared also move other discs, the lines are only an
+estimate, and the difference between the players' scores is added on top. A won game scores WIN_SCORE less the number
+of moves it took, so nearer wins are preferred.
+
+Each iteration starts from what the last one found. Its principal variation, the line of best play, is searched first,
+so the iteration soon has a good bound to cut the rest of the tree down with; the other moves are tried from the centre
+out. Each iteration after the first also searches with an aspiration window around the last iteration's score. Most of
+the time the score lands inside it, and the narrow window prunes more; when it falls outside, the window is widened on
+that side and the iteration searched again.
+
+The time allowed for each move comes from a TimeManager (see `timing`). No new iteration is started past its soft limit,
+and once its hard limit is reached the search stops mid-iteration: the clock is read every 256 nodes, and the moves
+played so far are taken back as the search unwinds. The move returned is then the best of the last complete iteration,
+or of the interrupted one if it had already finished searching a move that did better.
+
+Moves are played on a private copy of the game, played by stand-in players, so the game and its players are never
+changed. Games that can take their moves back (see `Game::supportsUndo`) are searched in place on that copy; others are
+copied again for every move.
+*/
+class IterativeDeepening {
+public:
+    /*
+    The Result of a search.
+    */
+    struct Result {
+        int column;                     // column to play, or -1 if the game isn't in progress
+        int score;                      // score of the last complete iteration for the player to move
+        unsigned int depth;             // depth of the last complete iteration, 0 if not even the first finished
+        bool interrupted;               // true if the hard limit stopped an iteration part way through
+        std::vector<unsigned int> line; // principal variation of the last complete iteration, starting with `column`
+        unsigned long long nodes;       // positions searched over every iteration
+        unsigned int researches;        // iterations searched again with a wider aspiration window
+        unsigned int milliseconds;      // time taken by the search
+    };
+
+    /*
+    The score of a won game, less the number of moves it took.
+    */
+    static const int WIN_SCORE = 1 << 24;
+
+    /*
+    The deepest an iteration can search.
+    */
+    static const unsigned int MAX_DEPTH = 64;
+
+    /*
+    Create a search running iterations of up to 8 plies, without a time limit.
+    */
+    IterativeDeepening();
+
+    /*
+    Stop after the iteration of the given depth. A limit of 0 searches as deep as the time allows (but no deeper than
+    MAX_DEPTH or the end of the game), and needs a time limit to finish on a large grid.
+    */
+    void setDepthLimit(unsigned int depth);
+
+    /*
+    Set the half-width of the aspiration window first tried around the last iteration's score (32 by default). A width
+    of 0 searches every iteration with a full window.
+    */
+    void setAspirationWindow(int width);
+
+    /*
+    Return the TimeManager that sets the time allowed for each move, to give it a move time or a clock.
+    */
+    TimeManager& timing() { return clock; }
+
+    /*
+    Search the current position of the game and return the move to play. The game itself is not changed. If the game is
+    not in progress the result has no column.
+    */
+    Result search(const Game& game);
+
+private:
+    /*
+    Private copy constructor and assignment operator - the stand-in players belong to a single search.
+    */
+    IterativeDeepening(const IterativeDeepening&);
+    IterativeDeepening& operator=(const IterativeDeepening&);
+
+    // Bound beyond every score
+    static const int INFINITE_SCORE = WIN_SCORE + 1;
+
+    // Score of each point of difference between the players' scores
+    static const int SCORE_WEIGHT = 100;
+
+    // Search the game to `depth` more moves within (alpha, beta), `ply` moves below the root. `estimate` is the score
+    // of the lines of the position for the player to move, relative to the root
+    int negamax(Game& game, unsigned int depth, int alpha, int beta, unsigned int ply, int estimate);
+
+    // Play the column, search the position it leads to and take it back, returning the score for the player who
+    // played it. The column must be playable
+    int searchMove(Game& game, unsigned int column, unsigned int depth, int alpha, int beta, unsigned int ply,
+                   int estimate);
+
+    // Change the lines score made by the disc just played at (row, column), for the player who played it
+    int linesPlayed(const Grid& grid, unsigned int row, unsigned int column) const;
+
+    unsigned int depthLimit;
+    int aspiration;
+    TimeManager clock;
+    Player standInOne;
+    Player standInTwo;
+    const Player* mover;                    // stand-in to move at the root
+    bool undo;                              // whether moves are taken back rather than copied
+    unsigned int length;                    // discs in a row needed to win
+    std::vector<unsigned int> columnOrder;  // columns from the centre out
+    std::vector<unsigned int> previousLine; // principal variation of the last complete iteration
+    bool followingLine;                     // whether the moves so far are those of previousLine
+    std::vector<unsigned int> lines;        // principal variation found below each ply, MAX_DEPTH + 1 entries apiece
+    std::vector<unsigned int> lineLengths;  // entries of each ply's principal variation, counted from the root
+    unsigned long long nodes;
+    bool stopped;                           // set once the hard limit is reached
+    int rootAlpha;                          // lower bound of the root window in the current pass
+    int rootBest;                           // best score at the root in the current pass
+    int rootColumn;                         // column with that score, -1 before a root move is finished
+};
+
+#endif /* end of include guard: ITERATIVEDEEPENING_HPP */
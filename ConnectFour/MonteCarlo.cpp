@@ -0,0 +1,450 @@
+#include "MonteCarlo.hpp"
+#include "Playout.hpp"
+#include "Position.hpp"
+#include <cmath>
+#include <thread>
+#include <typeinfo>
+
+struct MonteCarlo::Worker {
+	Worker() : one("Playout One"), two("Playout Two") {}
+
+	Player one;
+	Player two;
+	std::unique_ptr<Game> game;         // copy of the root's game, played by the worker's stand-ins
+	bool undo;                          // whether the game is explored in place, taking moves back afterwards
+	bool fast;                          // whether rollouts to the end of the game can be left to the Playout kernel
+	Playout playout;
+	uint64_t random;
+	unsigned long long iterations;
+	std::vector<unsigned int> path;     // nodes visited by the current iteration, from the root down
+	std::vector<unsigned int> columns;  // columns played to reach the last node of the path
+};
+
+// splitmix64, so that neighbouring seeds give unrelated sequences
+static uint64_t mixSeed(uint64_t value){
+	uint64_t z = value + 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return (z ^ (z >> 31)) | 1;	// xorshift must never be left at zero
+}
+
+// xorshift64*, scaled into [0, bound) using its high bits
+static unsigned int randomBelow(uint64_t& state, unsigned int bound){
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	uint64_t bits = (state * 0x2545F4914F6CDD1DULL) >> 32;
+	return (unsigned int)((bits * bound) >> 32);
+}
+
+// Hand the game over to the stand-ins, starting them from the scores of the game `from`
+static void useStandIns(Game& game, Player& one, Player& two, const Game& from){
+	one.setScore(from.score(Grid::GC_PLAYER_ONE));
+	two.setScore(from.score(Grid::GC_PLAYER_TWO));
+	game.setPlayerOne(&one);
+	game.setPlayerTwo(&two);
+}
+
+// Whether the two games are in the same state, whoever is playing them
+static bool sameState(const Game& a, const Game& b){
+	return a.status() == b.status() && a.turnCount() == b.turnCount() && a.supportsUndo() == b.supportsUndo()
+		&& a.winLength() == b.winLength() && a.score(Grid::GC_PLAYER_ONE) == b.score(Grid::GC_PLAYER_ONE)
+		&& a.score(Grid::GC_PLAYER_TWO) == b.score(Grid::GC_PLAYER_TWO) && a.grid()->sameDiscs(*b.grid());
+}
+
+// Reward of the game's outcome for Player One (played by `one`): the winner of a finished game, otherwise the leader
+static double playerOneReward(const Game& game, const Player& one){
+	if(game.status() == Game::GS_COMPLETE){
+		const Player* winner = game.winner();
+		return winner == 0 ? 0.5 : (winner == &one ? 1.0 : 0.0);
+	}
+	unsigned int scoreOne = game.score(Grid::GC_PLAYER_ONE);
+	unsigned int scoreTwo = game.score(Grid::GC_PLAYER_TWO);
+	return scoreOne == scoreTwo ? 0.5 : (scoreOne > scoreTwo ? 1.0 : 0.0);
+}
+
+MonteCarlo::Tree::Tree() : one("Tree One"), two("Tree Two"){
+}
+
+MonteCarlo::MonteCarlo(){
+	exploration = std::sqrt(2.0);
+	iterationLimit = 10000;
+	timeLimit = 0;
+	rolloutLimit = 0;
+	nodeLimit = 1 << 20;
+	threads = 1;
+	parallelism = MP_ROOT;
+	randomSeed = mixSeed(0);
+	started = 0;
+	stopped = false;
+	budget = 0;
+}
+
+void MonteCarlo::setExploration(double constant){
+	exploration = constant;
+}
+
+void MonteCarlo::setIterationLimit(unsigned long long iterations){
+	iterationLimit = iterations;
+}
+
+void MonteCarlo::setTimeLimit(unsigned int milliseconds){
+	timeLimit = milliseconds;
+}
+
+void MonteCarlo::setRolloutLimit(unsigned int moves){
+	rolloutLimit = moves;
+}
+
+void MonteCarlo::setNodeLimit(unsigned int nodes){
+	nodeLimit = nodes == 0 ? 1 : nodes;
+}
+
+void MonteCarlo::setThreads(unsigned int count){
+	if(count == 0){
+		count = std::thread::hardware_concurrency();
+	}
+	threads = count == 0 ? 1 : count;
+}
+
+void MonteCarlo::setParallelism(Parallelism parallelism){
+	if(parallelism != this->parallelism){
+		clear();
+	}
+	this->parallelism = parallelism;
+}
+
+void MonteCarlo::seed(uint64_t value){
+	randomSeed = mixSeed(value);
+}
+
+void MonteCarlo::clear(){
+	trees.clear();
+}
+
+unsigned int MonteCarlo::select(const Tree& tree, unsigned int node) const{
+	const Node& parent = tree.nodes[node];
+	double logVisits = std::log((double)parent.visits);
+	unsigned int best = parent.firstChild;
+	double bestValue = -1;
+	for(unsigned int i = parent.firstChild; i < parent.firstChild + parent.childCount; i++){
+		const Node& child = tree.nodes[i];
+		if(child.visits == 0){
+			return i;
+		}
+		double value = child.reward / child.visits + exploration * std::sqrt(logVisits / child.visits);
+		if(value > bestValue){
+			bestValue = value;
+			best = i;
+		}
+	}
+	return best;
+}
+
+void MonteCarlo::expand(Tree& tree, unsigned int node, const Game& game){
+	const Grid& grid = *game.grid();
+	unsigned int playable = 0;
+	for(unsigned int c = 0; c < grid.columnCount(); c++){
+		playable += grid.isColumnFull(c) ? 0 : 1;
+	}
+	if(playable == 0 || tree.nodes.size() + playable > nodeLimit){
+		return;
+	}
+	// The children go in as one block, so a node only needs to know where its block starts
+	unsigned int first = tree.nodes.size();
+	bool playerOneMoves = game.turnCount() % 2 == 0;
+	for(unsigned int c = 0; c < grid.columnCount(); c++){
+		if(!grid.isColumnFull(c)){
+			Node child = { node, NO_NODE, 0, c, 0, 0.0, playerOneMoves };
+			tree.nodes.push_back(child);
+		}
+	}
+	tree.nodes[node].firstChild = first;
+	tree.nodes[node].childCount = playable;
+}
+
+void MonteCarlo::iterate(Tree& tree, Worker& worker, bool shared){
+	Game& game = *worker.game;
+	if(!worker.undo){
+		game = *tree.root;
+		useStandIns(game, worker.one, worker.two, *tree.root);
+	}
+
+	// Walk down the tree, counting the visits on the way so other threads sharing the tree look elsewhere
+	std::unique_lock<std::mutex> guard(tree.lock, std::defer_lock);
+	if(shared){
+		guard.lock();
+	}
+	worker.path.clear();
+	worker.columns.clear();
+	unsigned int node = 0;
+	tree.nodes[node].visits++;
+	worker.path.push_back(node);
+	while(tree.nodes[node].firstChild != NO_NODE){
+		node = select(tree, node);
+		tree.nodes[node].visits++;
+		worker.path.push_back(node);
+		worker.columns.push_back(tree.nodes[node].column);
+	}
+	if(shared){
+		guard.unlock();
+	}
+	unsigned int played = 0;
+	for(unsigned int i = 0; i < worker.columns.size(); i++){
+		played += game.playNextTurn(worker.columns[i]) ? 1 : 0;
+	}
+
+	// Grow the tree by the leaf's children, and carry on into the first of them
+	if(game.status() == Game::GS_IN_PROGRESS){
+		if(shared){
+			guard.lock();
+		}
+		if(tree.nodes[node].firstChild == NO_NODE){
+			expand(tree, node, game);
+		}
+		int column = -1;
+		if(tree.nodes[node].firstChild != NO_NODE){
+			node = select(tree, node);
+			tree.nodes[node].visits++;
+			worker.path.push_back(node);
+			column = tree.nodes[node].column;
+		}
+		if(shared){
+			guard.unlock();
+		}
+		if(column >= 0){
+			played += game.playNextTurn(column) ? 1 : 0;
+		}
+	}
+
+	// Play random moves until the game is over or the rollout is long enough
+	const Grid& grid = *game.grid();
+	if(worker.fast && game.status() == Game::GS_IN_PROGRESS
+		&& (rolloutLimit == 0 || rolloutLimit >= grid.rowCount() * grid.columnCount() - grid.discCount())){
+		// The rollout can't be cut short, so only its outcome matters
+		Grid::Cell winner = worker.playout.play(Position(grid));
+		if(worker.playout.moveCount() == grid.rowCount() * grid.columnCount()){
+			winner = Grid::GC_EMPTY;	// a game that fills the grid has no winner (see Game::winner)
+		}
+		double reward = winner == Grid::GC_EMPTY ? 0.5 : (winner == Grid::GC_PLAYER_ONE ? 1.0 : 0.0);
+		finish(tree, worker, shared, reward, played);
+		return;
+	}
+	unsigned int columns = grid.columnCount();
+	for(unsigned int moves = 0; game.status() == Game::GS_IN_PROGRESS && (rolloutLimit == 0 || moves < rolloutLimit);
+		moves++){
+		unsigned int column = randomBelow(worker.random, columns);
+		while(game.grid()->isColumnFull(column)){
+			column = (column + 1) % columns;
+		}
+		played += game.playNextTurn(column) ? 1 : 0;
+	}
+	finish(tree, worker, shared, playerOneReward(game, worker.one), played);
+}
+
+void MonteCarlo::finish(Tree& tree, Worker& worker, bool shared, double reward, unsigned int played){
+	std::unique_lock<std::mutex> guard(tree.lock, std::defer_lock);
+	if(shared){
+		guard.lock();
+	}
+	for(unsigned int i = 0; i < worker.path.size(); i++){
+		Node& visited = tree.nodes[worker.path[i]];
+		visited.reward += visited.playerOneMoved ? reward : 1 - reward;
+	}
+	if(shared){
+		guard.unlock();
+	}
+	if(worker.undo){
+		for(unsigned int i = 0; i < played; i++){
+			worker.game->undoMove();
+		}
+	}
+	worker.iterations++;
+}
+
+void MonteCarlo::work(Tree& tree, Worker& worker){
+	bool shared = parallelism == MP_TREE && threads > 1;
+	while(!stopped.load(std::memory_order_relaxed)){
+		if(budget != 0 && started.fetch_add(1, std::memory_order_relaxed) >= budget){
+			break;
+		}
+		if(timeLimit != 0){
+			std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - startTime;
+			if(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() >= timeLimit){
+				stopped = true;
+				break;
+			}
+		}
+		iterate(tree, worker, shared);
+	}
+}
+
+void MonteCarlo::reroot(Tree& tree, unsigned int node){
+	// Copy the subtree breadth first, so every block of children stays together
+	std::vector<Node> kept;
+	kept.push_back(tree.nodes[node]);
+	kept[0].parent = NO_NODE;
+	for(unsigned int i = 0; i < kept.size(); i++){
+		unsigned int first = kept[i].firstChild;
+		if(first == NO_NODE){
+			continue;
+		}
+		kept[i].firstChild = kept.size();
+		for(unsigned int k = 0; k < kept[i].childCount; k++){
+			Node child = tree.nodes[first + k];
+			child.parent = i;
+			kept.push_back(child);
+		}
+	}
+	tree.nodes.swap(kept);
+}
+
+unsigned long long MonteCarlo::reuse(Tree& tree, const Game& game){
+	// Look for the game among the positions one and two moves below the old root
+	unsigned int match = NO_NODE;
+	if(!tree.nodes.empty() && tree.root){
+		if(sameState(*tree.root, game)){
+			match = 0;
+		}
+		Player one("Match One");
+		Player two("Match Two");
+		Player replyOne("Match Reply One");
+		Player replyTwo("Match Reply Two");
+		const Node& root = tree.nodes[0];
+		for(unsigned int i = root.firstChild; match == NO_NODE && root.firstChild != NO_NODE
+				&& i < root.firstChild + root.childCount; i++){
+			std::unique_ptr<Game> first(tree.root->clone());
+			useStandIns(*first, one, two, *tree.root);
+			if(!first->playNextTurn(tree.nodes[i].column)){
+				continue;
+			}
+			if(sameState(*first, game)){
+				match = i;
+				break;
+			}
+			const Node& child = tree.nodes[i];
+			for(unsigned int j = child.firstChild; child.firstChild != NO_NODE && j < child.firstChild + child.childCount;
+					j++){
+				std::unique_ptr<Game> second(first->clone());
+				useStandIns(*second, replyOne, replyTwo, *first);
+				if(second->playNextTurn(tree.nodes[j].column) && sameState(*second, game)){
+					match = j;
+					break;
+				}
+			}
+		}
+	}
+
+	unsigned long long kept = 0;
+	if(match == NO_NODE){
+		tree.nodes.clear();
+	} else {
+		if(match != 0){
+			reroot(tree, match);
+		}
+		kept = tree.nodes.size();
+	}
+	tree.root.reset(game.clone());
+	useStandIns(*tree.root, tree.one, tree.two, game);
+	if(tree.nodes.empty()){
+		// the root's own reward is never used, but its mover is whoever isn't moving now
+		Node root = { NO_NODE, NO_NODE, 0, 0, 0, 0.0, game.turnCount() % 2 != 0 };
+		tree.nodes.push_back(root);
+	}
+	return kept;
+}
+
+MonteCarlo::Result MonteCarlo::search(const Game& game){
+	startTime = std::chrono::steady_clock::now();
+	Result result;
+	result.column = -1;
+	result.value = 0;
+	result.iterations = 0;
+	result.nodes = 0;
+	result.reused = 0;
+	result.milliseconds = 0;
+	if(game.status() != Game::GS_IN_PROGRESS){
+		return result;
+	}
+
+	unsigned int treeCount = parallelism == MP_ROOT ? threads : 1;
+	if(trees.size() != treeCount){
+		trees.clear();
+		for(unsigned int i = 0; i < treeCount; i++){
+			trees.push_back(std::unique_ptr<Tree>(new Tree()));
+		}
+	}
+	for(unsigned int i = 0; i < treeCount; i++){
+		result.reused += reuse(*trees[i], game);
+	}
+
+	budget = iterationLimit;
+	if(budget == 0 && timeLimit == 0){
+		budget = 10000;
+	}
+	started = 0;
+	stopped = false;
+	std::unique_ptr<Worker[]> workers(new Worker[threads]);
+	for(unsigned int i = 0; i < threads; i++){
+		Tree& tree = *trees[i % treeCount];
+		workers[i].game.reset(tree.root->clone());
+		useStandIns(*workers[i].game, workers[i].one, workers[i].two, *tree.root);
+		workers[i].undo = game.supportsUndo();
+		workers[i].fast = typeid(game) == typeid(Game) && game.winLength() == 4
+			&& Position::fits(game.grid()->rowCount(), game.grid()->columnCount());
+		workers[i].random = mixSeed(randomSeed + i);
+		workers[i].playout.seed(workers[i].random);
+		workers[i].iterations = 0;
+	}
+	randomSeed = mixSeed(randomSeed);	// the next search plays different rollouts
+
+	std::vector<std::thread> helpers;
+	for(unsigned int i = 1; i < threads; i++){
+		helpers.push_back(std::thread(&MonteCarlo::work, this, std::ref(*trees[i % treeCount]), std::ref(workers[i])));
+	}
+	work(*trees[0], workers[0]);
+	for(unsigned int i = 0; i < helpers.size(); i++){
+		helpers[i].join();
+	}
+
+	// Add up the root children of every tree, and play the column visited most (the better reward breaking ties)
+	unsigned int columns = game.grid()->columnCount();
+	std::vector<unsigned long long> visits(columns, 0);
+	std::vector<double> rewards(columns, 0.0);
+	for(unsigned int t = 0; t < treeCount; t++){
+		const Tree& tree = *trees[t];
+		const Node& root = tree.nodes[0];
+		for(unsigned int i = root.firstChild; root.firstChild != NO_NODE && i < root.firstChild + root.childCount; i++){
+			visits[tree.nodes[i].column] += tree.nodes[i].visits;
+			rewards[tree.nodes[i].column] += tree.nodes[i].reward;
+		}
+		result.nodes += tree.nodes.size();
+	}
+	for(unsigned int c = 0; c < columns; c++){
+		if(visits[c] == 0){
+			continue;
+		}
+		double value = rewards[c] / visits[c];
+		if(result.column < 0 || visits[c] > visits[result.column]
+			|| (visits[c] == visits[result.column] && value > result.value)){
+			result.column = c;
+			result.value = value;
+		}
+	}
+	if(result.column < 0){
+		// out of time before a single move was tried
+		for(unsigned int c = 0; c < columns && result.column < 0; c++){
+			if(!game.grid()->isColumnFull(c)){
+				result.column = c;
+				result.value = 0.5;
+			}
+		}
+	}
+
+	for(unsigned int i = 0; i < threads; i++){
+		result.iterations += workers[i].iterations;
+	}
+	std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - startTime;
+	result.milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+	return result;
+}
@@ -0,0 +1,196 @@
+#ifndef MONTECARLO_HPP
+#define MONTECARLO_HPP
+
+#include "Game.hpp"
+#include "Player.hpp"
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+MonteCarlo chooses moves by Monte Carlo Tree Search (UCT), for games where the Solver can't help: grids too large for a
+Position, other win lengths, and SuperGame, where the score depends on the combos cleared and the cascades that follow.
+It only relies on `Game::playNextTurn` and `Game::status`, so it plays by whatever rules the game it's given plays by.
+
+Every iteration walks down the tree from the current position, at each node picking the child with the best upper
+confidence bound (its average reward plus `exploration` * sqrt(ln(parent visits) / child visits), unvisited children
+first), adds the children of the node it stops at, and plays random moves from there until the game is over or the
+rollout limit is reached. The reward is 1 for a win, 0 for a loss and 1/2 for a draw, from the point of view of the
+player who made each move on the way down, with the winner as `Game::winner` has it: in a standard game, four in a row
+made by the disc that fills the grid is a draw. A rollout cut short goes to the player with the higher score, or counts
+as a draw when the scores are level. The move played is the root child visited most often.
+
+Rollouts of a standard game (a plain Game, four in a row) small enough for a Position, which won't be cut short by the
+rollout limit, are played by a Playout on the bitboards rather than on the game, since only their outcome is needed. A
+Playout counts four in a row with the last disc as a win, so those rollouts are scored as draws instead.
+
+Nodes are allocated from a pool: the children of a node are added together, as a contiguous block, and are addressed by
+index rather than by pointer. Once the pool holds the node limit, leaves are no longer expanded and iterations carry on
+from the existing tree.
+
+The tree is kept between searches. When the next search is given the position the tree was built for, or one reached
+from it by one or two moves, the matching subtree becomes the new root and its statistics are reused; anything else
+starts a fresh tree.
+
+Moves are played on private copies of the game, played by stand-in players, so the game and its players are never
+changed. Games that can take their moves back (see `Game::supportsUndo`) are explored in place on one copy per thread;
+others are copied again for every iteration.
+
+A search can run on several threads. With MP_ROOT every thread grows its own tree from the same position and the visits
+of the root children are added together at the end; with MP_TREE the threads share one tree, taking a lock to walk it
+and to record their results but not while playing their rollouts. A thread walking the tree counts its visits straight
+away (a virtual loss), so threads sharing a tree spread out over different lines. With a single thread (the default) a
+search is deterministic for a given seed.
+*/
+class MonteCarlo {
+public:
+    /*
+    The Parallelism enum selects how several threads share a search: MP_ROOT gives every thread its own tree, MP_TREE
+    shares a single tree between them.
+    */
+    enum Parallelism { MP_ROOT, MP_TREE };
+
+    /*
+    The Result of a search.
+    */
+    struct Result {
+        int column;                     // most visited column, or -1 if the game isn't in progress
+        double value;                   // average reward of that column for the player to move, between 0 and 1
+        unsigned long long iterations;  // iterations run, summed over every thread
+        unsigned long long nodes;       // nodes in the tree (or trees) at the end of the search
+        unsigned long long reused;      // nodes carried over from the previous search
+        unsigned int milliseconds;      // time taken by the search
+    };
+
+    /*
+    Create a search running 10000 iterations on one thread, with an exploration constant of sqrt(2), rollouts played to
+    the end of the game and a pool of 2^20 nodes.
+    */
+    MonteCarlo();
+
+    /*
+    Set the exploration constant of the upper confidence bound. Higher values try more moves, lower values look deeper
+    into the moves that have done well so far.
+    */
+    void setExploration(double constant);
+
+    /*
+    Limit every search to the given number of iterations, summed over every thread. A limit of 0 means no limit; if the
+    time limit is also 0, searches run 10000 iterations.
+    */
+    void setIterationLimit(unsigned long long iterations);
+
+    /*
+    Limit every search to (roughly) the given number of milliseconds. A limit of 0 means no limit.
+    */
+    void setTimeLimit(unsigned int milliseconds);
+
+    /*
+    Stop every rollout after the given number of moves, or play them to the end of the game for a limit of 0.
+    */
+    void setRolloutLimit(unsigned int moves);
+
+    /*
+    Set the largest number of nodes a tree may hold (at least 1).
+    */
+    void setNodeLimit(unsigned int nodes);
+
+    /*
+    Set the number of threads each search runs on. A count of 0 uses one thread per core.
+    */
+    void setThreads(unsigned int count);
+
+    /*
+    Set how several threads share a search. Changing it discards the tree.
+    */
+    void setParallelism(Parallelism parallelism);
+
+    /*
+    Restart the random moves of the rollouts from the given seed.
+    */
+    void seed(uint64_t value);
+
+    /*
+    Search the current position of the game, which must be in progress, and return the move to play. The game itself
+    is not changed. If the game is not in progress the result has no column.
+    */
+    Result search(const Game& game);
+
+    /*
+    Discard the tree, so the next search starts afresh.
+    */
+    void clear();
+
+private:
+    /*
+    Private copy constructor and assignment operator - the trees can't be copied.
+    */
+    MonteCarlo(const MonteCarlo&);
+    MonteCarlo& operator=(const MonteCarlo&);
+
+    // Index of a node that doesn't exist
+    static const unsigned int NO_NODE = 0xFFFFFFFF;
+
+    struct Node {
+        unsigned int parent;        // NO_NODE for the root
+        unsigned int firstChild;    // NO_NODE until the node is expanded
+        unsigned int childCount;
+        unsigned int column;        // column played to reach the node
+        unsigned int visits;
+        double reward;              // summed over the visits, for the player who played `column`
+        bool playerOneMoved;        // whether Player One played `column`
+    };
+
+    // A search tree and a copy of the game at its root, played by the tree's own stand-in players
+    struct Tree {
+        Tree();
+        std::vector<Node> nodes;
+        std::unique_ptr<Game> root;
+        Player one;
+        Player two;
+        std::mutex lock;
+    };
+
+    // The state of a single thread's search
+    struct Worker;
+
+    // Make the tree's root the given game, keeping the part of the tree that matches it. Returns the nodes kept.
+    unsigned long long reuse(Tree& tree, const Game& game);
+
+    // Make the node the root of the tree, dropping every node outside its subtree
+    void reroot(Tree& tree, unsigned int node);
+
+    // Run iterations on the tree until the search is out of budget
+    void work(Tree& tree, Worker& worker);
+
+    // Run a single iteration on the tree
+    void iterate(Tree& tree, Worker& worker, bool shared);
+
+    // Add the iteration's reward to the nodes on its path and take back the `played` moves of the worker's game
+    void finish(Tree& tree, Worker& worker, bool shared, double reward, unsigned int played);
+
+    // Child of the (expanded) node with the best upper confidence bound
+    unsigned int select(const Tree& tree, unsigned int node) const;
+
+    // Add a child for every playable column of the worker's game to the node, if the pool has room
+    void expand(Tree& tree, unsigned int node, const Game& game);
+
+    double exploration;
+    unsigned long long iterationLimit;
+    unsigned int timeLimit;
+    unsigned int rolloutLimit;
+    unsigned int nodeLimit;
+    unsigned int threads;
+    Parallelism parallelism;
+    uint64_t randomSeed;
+    std::vector<std::unique_ptr<Tree> > trees;
+    std::atomic<unsigned long long> started;    // iterations started by every thread in the current search
+    std::atomic<bool> stopped;                  // set once the current search is out of time
+    unsigned long long budget;                  // iteration limit of the current search, 0 for none
+    std::chrono::steady_clock::time_point startTime;
+};
+
+#endif /* end of include guard: MONTECARLO_HPP */
@@ -0,0 +1,266 @@
+#include "OpeningBook.hpp"
+#include "Solver.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char MAGIC[4] = { 'C', '4', 'O', 'B' };
+static const uint32_t VERSION = 1;
+
+struct BookHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t rows;
+	uint32_t columns;
+	uint32_t depth;
+	uint32_t reserved;
+	uint64_t count;
+};
+
+// A position waiting to be solved, filed under the smaller of its key and its mirror image's key
+struct BookPending {
+	uint64_t key;
+	bool mirrored;      // whether `key` is the mirror image's key
+	Position position;
+
+	bool operator<(const BookPending& other) const { return key < other.key; }
+	bool operator==(const BookPending& other) const { return key == other.key; }
+};
+
+struct BookEntry {
+	uint64_t key;
+	signed char score;
+	unsigned char column;
+
+	bool operator<(const BookEntry& other) const { return key < other.key; }
+};
+
+OpeningBook::OpeningBook(){
+	data = 0;
+	length = 0;
+	keys = 0;
+	scores = 0;
+	moves = 0;
+	count = 0;
+	rows = 0;
+	columns = 0;
+	maxMoves = 0;
+}
+
+OpeningBook::~OpeningBook(){
+	close();
+}
+
+bool OpeningBook::generate(const std::string& path, unsigned int rows, unsigned int columns, unsigned int depth,
+						   Solver& solver){
+	if(!Position::fits(rows, columns)){
+		return false;
+	}
+	Position start(rows, columns);
+	rows = start.rowCount();
+	columns = start.columnCount();
+	unsigned int cells = rows * columns;
+
+	// Collect the positions one move at a time, keeping one of each position and its mirror image
+	std::vector<std::vector<BookPending> > layers(1);
+	BookPending root = { start.key(), false, start };
+	layers[0].push_back(root);
+	for(unsigned int moveCount = 1; moveCount <= depth && moveCount < cells; moveCount++){
+		const std::vector<BookPending>& previous = layers.back();
+		std::vector<BookPending> next;
+		for(unsigned int i = 0; i < previous.size(); i++){
+			const Position& position = previous[i].position;
+			for(unsigned int c = 0; c < columns; c++){
+				if(!position.canPlay(c) || position.isWinningMove(c)){
+					continue;
+				}
+				BookPending child = { 0, false, position };
+				child.position.play(c);
+				uint64_t key = child.position.key();
+				uint64_t mirrored = child.position.mirroredKey();
+				child.key = std::min(key, mirrored);
+				child.mirrored = mirrored < key;
+				next.push_back(child);
+			}
+		}
+		std::sort(next.begin(), next.end());
+		next.erase(std::unique(next.begin(), next.end()), next.end());
+		if(next.empty()){
+			break;
+		}
+		layers.push_back(next);
+	}
+
+	// Only the deepest positions are searched. Every shallower position's score follows from its children's: the best
+	// of their scores, negated, unless it can win straight away
+	std::vector<unsigned int> order(columns);
+	for(unsigned int i = 0; i < columns; i++){
+		// from the centre out, as the solver prefers among equal moves
+		int offset = (i % 2 == 0) ? (int)(i + 1) / 2 : -(int)(i + 1) / 2;
+		order[i] = columns / 2 + offset;
+	}
+	std::vector<BookEntry> entries;
+	std::vector<BookEntry> below;	// entries of the layer below the one being filled in, sorted by key
+	for(unsigned int d = layers.size(); d-- > 0;){
+		std::vector<BookEntry> layer;
+		for(unsigned int i = 0; i < layers[d].size(); i++){
+			const BookPending& pending = layers[d][i];
+			const Position& position = pending.position;
+			BookEntry entry;
+			entry.key = pending.key;
+			int score;
+			int column = -1;
+			if(d + 1 == layers.size()){
+				Solver::Result result = solver.solve(position);
+				if(!result.complete || result.column < 0){
+					continue;	// out of budget, and so are the positions leading only here
+				}
+				score = result.score;
+				column = result.column;
+			} else if(position.canWinNext()){
+				score = (cells + 1 - position.moveCount()) / 2;
+				for(unsigned int k = 0; k < columns && column < 0; k++){
+					if(position.canPlay(order[k]) && position.isWinningMove(order[k])){
+						column = order[k];
+					}
+				}
+			} else {
+				// The score is settled once every child is known, or one reaches the best score the position can have
+				int best = -(int)cells;
+				int bound = (int)(cells - 1 - position.moveCount()) / 2;
+				bool known = true;
+				for(unsigned int k = 0; k < columns && best < bound; k++){
+					if(!position.canPlay(order[k])){
+						continue;
+					}
+					Position child(position);
+					child.play(order[k]);
+					int childScore = 0;	// a full grid is a draw
+					if(child.moveCount() < cells){
+						BookEntry wanted;
+						wanted.key = std::min(child.key(), child.mirroredKey());
+						std::vector<BookEntry>::const_iterator found =
+							std::lower_bound(below.begin(), below.end(), wanted);
+						if(found == below.end() || found->key != wanted.key){
+							known = false;
+							continue;
+						}
+						childScore = found->score;
+					}
+					if(-childScore > best){
+						best = -childScore;
+						column = order[k];
+					}
+				}
+				if(!known && best < bound){
+					continue;
+				}
+				score = best;
+			}
+			entry.score = score;
+			entry.column = pending.mirrored ? columns - 1 - column : column;
+			layer.push_back(entry);
+		}
+		// Layers were built sorted and stay that way with entries left out
+		entries.insert(entries.end(), layer.begin(), layer.end());
+		below.swap(layer);
+	}
+	std::sort(entries.begin(), entries.end());
+
+	BookHeader header;
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.rows = rows;
+	header.columns = columns;
+	header.depth = depth;
+	header.reserved = 0;
+	header.count = entries.size();
+	std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+	file.write((const char*)&header, sizeof(header));
+	for(unsigned int i = 0; i < entries.size(); i++){
+		file.write((const char*)&entries[i].key, sizeof(uint64_t));
+	}
+	for(unsigned int i = 0; i < entries.size(); i++){
+		file.write((const char*)&entries[i].score, 1);
+	}
+	for(unsigned int i = 0; i < entries.size(); i++){
+		file.write((const char*)&entries[i].column, 1);
+	}
+	file.close();
+	return !file.fail();
+}
+
+bool OpeningBook::open(const std::string& path){
+	close();
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0){
+		return false;
+	}
+	struct stat info;
+	void* mapped = MAP_FAILED;
+	if(fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(BookHeader)){
+		mapped = mmap(0, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	}
+	::close(fd);	// the mapping stays valid without the descriptor
+	if(mapped == MAP_FAILED){
+		return false;
+	}
+
+	const BookHeader* header = (const BookHeader*)mapped;
+	size_t size = info.st_size;
+	bool valid = std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0 && header->version == VERSION
+		&& Position::fits(header->rows, header->columns) && header->rows >= 4 && header->columns >= 4
+		&& header->count <= (size - sizeof(BookHeader)) / 10 && size == sizeof(BookHeader) + header->count * 10;
+	if(!valid){
+		munmap(mapped, size);
+		return false;
+	}
+	data = (const unsigned char*)mapped;
+	length = size;
+	count = header->count;
+	rows = header->rows;
+	columns = header->columns;
+	maxMoves = header->depth;
+	keys = (const uint64_t*)(data + sizeof(BookHeader));
+	scores = (const signed char*)(data + sizeof(BookHeader) + count * sizeof(uint64_t));
+	moves = (const unsigned char*)(scores + count);
+	return true;
+}
+
+void OpeningBook::close(){
+	if(data != 0){
+		munmap((void*)data, length);
+	}
+	data = 0;
+	length = 0;
+	keys = 0;
+	scores = 0;
+	moves = 0;
+	count = 0;
+	rows = 0;
+	columns = 0;
+	maxMoves = 0;
+}
+
+bool OpeningBook::probe(const Position& position, int& score, int& column) const{
+	if(data == 0 || position.rowCount() != rows || position.columnCount() != columns
+		|| position.moveCount() > maxMoves){
+		return false;
+	}
+	uint64_t key = position.key();
+	uint64_t mirrored = position.mirroredKey();
+	uint64_t wanted = std::min(key, mirrored);
+	const uint64_t* found = std::lower_bound(keys, keys + count, wanted);
+	if(found == keys + count || *found != wanted){
+		return false;
+	}
+	uint64_t index = found - keys;
+	score = scores[index];
+	column = mirrored < key ? columns - 1 - moves[index] : moves[index];
+	return true;
+}
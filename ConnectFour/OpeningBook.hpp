@@ -0,0 +1,118 @@
+#ifndef OPENINGBOOK_HPP
+#define OPENINGBOOK_HPP
+
+#include "Position.hpp"
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+
+class Solver;
+
+/*
+An OpeningBook holds the solved score and best move of every position of a grid size up to a given number of moves, so
+the opening of a game, where solving is most expensive, takes a single binary search instead of a search.
+
+A book is written once with `generate` and read with `open`, which maps the file into memory: nothing is parsed or
+copied when it is opened, and lookups read the mapped file directly. A position and its mirror image (columns reversed)
+have the same score, so only the one with the smaller key is stored, halving the size of the book.
+
+The file holds, in the byte order of the machine that wrote it, a 32-byte header:
+
+    char     magic[4]       "C4OB"
+    uint32_t version        1
+    uint32_t rows
+    uint32_t columns
+    uint32_t depth          positions of up to this many moves are held
+    uint32_t reserved       0
+    uint64_t count          number of entries
+
+followed by `count` 64-bit keys (see `Position::key`) in increasing order, then one signed byte per entry holding the
+score (see Solver) and one byte per entry holding the best column. An entry is 10 bytes.
+
+Positions where the game is already over (the last move made four in a row, or the grid is full) are not held. Once
+open, a book is never modified, so any number of threads can look positions up at once.
+*/
+class OpeningBook {
+public:
+    /*
+    Create an OpeningBook with no file open.
+    */
+    OpeningBook();
+
+    /*
+    Unmap the book's file, if one is open.
+    */
+    ~OpeningBook();
+
+    /*
+    Solve every position of the given size reachable in up to `depth` moves, and write them to a book file at `path`.
+    Only the positions of exactly `depth` moves are searched, with `solver`, whose node and time limits apply to each of
+    them. Every shallower position is then scored from the positions its moves lead to, without a search, working back
+    to the empty grid. Positions the solver can't solve completely within its budget are left out, along with any
+    shallower position whose score depends on them. Returns `false` if the grid doesn't fit a Position or the file can't
+    be written.
+    */
+    static bool generate(const std::string& path, unsigned int rows, unsigned int columns, unsigned int depth,
+                         Solver& solver);
+
+    /*
+    Map the book file at `path` into memory, closing any book already open. Returns `false`, leaving no book open, if
+    the file can't be read or isn't a valid book.
+    */
+    bool open(const std::string& path);
+
+    /*
+    Unmap the book's file. Does nothing if no book is open.
+    */
+    void close();
+
+    /*
+    Return `true` if a book is open.
+    */
+    bool isOpen() const { return data != 0; }
+
+    /*
+    Return the number of rows of the book's positions, or 0 if no book is open.
+    */
+    unsigned int rowCount() const { return rows; }
+
+    /*
+    Return the number of columns of the book's positions, or 0 if no book is open.
+    */
+    unsigned int columnCount() const { return columns; }
+
+    /*
+    Return the largest number of moves of the positions held.
+    */
+    unsigned int depth() const { return maxMoves; }
+
+    /*
+    Return the number of entries in the book.
+    */
+    uint64_t size() const { return count; }
+
+    /*
+    Look the position up, filling in its score for the player to move and the best column to play. Returns `false` if
+    the position isn't in the book: it's the wrong size, has more moves than the book's depth, or the game is over.
+    */
+    bool probe(const Position& position, int& score, int& column) const;
+
+private:
+    /*
+    Private copy constructor and assignment operator - the mapping belongs to a single book.
+    */
+    OpeningBook(const OpeningBook&);
+    OpeningBook& operator=(const OpeningBook&);
+
+    const unsigned char* data;  // the mapped file
+    size_t length;
+    const uint64_t* keys;
+    const signed char* scores;
+    const unsigned char* moves;
+    uint64_t count;
+    unsigned int rows;
+    unsigned int columns;
+    unsigned int maxMoves;
+};
+
+#endif /* end of include guard: OPENINGBOOK_HPP */
@@ -0,0 +1,90 @@
+#include "Perft.hpp"
+#include <memory>
+
+Perft::Perft() : standInOne("Stand-in One"), standInTwo("Stand-in Two"){
+	method = PM_UNDO;
+	copying = false;
+	moves = 0;
+}
+
+void Perft::setMethod(Method method){
+	this->method = method;
+}
+
+unsigned long long Perft::movesPlayed() const{
+	return moves;
+}
+
+Game* Perft::prepare(Game& game){
+	copying = (method == PM_COPY || !game.supportsUndo());
+	if(!copying){
+		return &game;
+	}
+	// Copies share the game's players, so hand the copy to the stand-ins before anything is played on it
+	Game* copy = game.clone();
+	copy->setPlayerOne(&standInOne);
+	copy->setPlayerTwo(&standInTwo);
+	return copy;
+}
+
+unsigned long long Perft::count(Game& game, unsigned int depth){
+	if(depth == 0){
+		return 1;
+	}
+	if(game.status() != Game::GS_IN_PROGRESS){
+		return 0;
+	}
+	Game* root = prepare(game);
+	unsigned long long total = search(*root, depth);
+	if(root != &game){
+		delete root;
+	}
+	return total;
+}
+
+std::vector<unsigned long long> Perft::divide(Game& game, unsigned int depth){
+	std::vector<unsigned long long> counts;
+	if(depth == 0 || game.status() != Game::GS_IN_PROGRESS){
+		return counts;
+	}
+	Game* root = prepare(game);
+	for(unsigned int c = 0; c < root->grid()->columnCount(); c++){
+		counts.push_back(searchColumn(*root, c, depth));
+	}
+	if(root != &game){
+		delete root;
+	}
+	return counts;
+}
+
+unsigned long long Perft::search(Game& game, unsigned int depth){
+	unsigned long long total = 0;
+	for(unsigned int c = 0; c < game.grid()->columnCount(); c++){
+		total += searchColumn(game, c, depth);
+	}
+	return total;
+}
+
+unsigned long long Perft::searchColumn(Game& game, unsigned int column, unsigned int depth){
+	if(copying){
+		std::unique_ptr<Game> child(game.clone());
+		if(!child->playNextTurn(column)){
+			return 0;
+		}
+		moves++;
+		if(depth == 1){
+			return 1;
+		}
+		return child->status() == Game::GS_IN_PROGRESS ? search(*child, depth - 1) : 0;
+	}
+	if(!game.playNextTurn(column)){
+		return 0;
+	}
+	moves++;
+	unsigned long long total = 1;
+	if(depth > 1){
+		total = game.status() == Game::GS_IN_PROGRESS ? search(game, depth - 1) : 0;
+	}
+	game.undoMove();
+	return total;
+}
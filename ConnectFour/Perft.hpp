@@ -0,0 +1,75 @@
+#ifndef PERFT_HPP
+#define PERFT_HPP
+
+#include "Game.hpp"
+#include "Player.hpp"
+#include <vector>
+
+/*
+Perft counts every sequence of legal moves of a given length from the current state of a Game or SuperGame, by playing
+each move of each sequence through `playNextTurn`. The counts depend only on the rules, so they check that the grid and
+the win checks still behave exactly the same way after they are rewritten, and the time taken to count them measures how
+fast moves are played and checked.
+
+Only the moves made once the game is complete end a sequence early: a sequence that reaches a complete game before its
+last move is not counted, as in chess perft. The count for a depth of 0 is 1.
+
+Moves are normally played on the game itself and then taken back with `Game::undoMove`, which leaves the game and its
+players exactly as they were. Games whose moves can't be taken back (see `Game::supportsUndo`), or every game when
+PM_COPY is selected, are instead copied with `Game::clone` before each move, and the copies are played by a pair of
+stand-in players, so neither the game nor its players are changed at all.
+*/
+class Perft {
+public:
+    /*
+    The Method enum selects how the moves are explored: PM_UNDO plays each move on the game itself and takes it back
+    afterwards whenever the game allows it, and PM_COPY plays each move on a fresh copy of the game.
+    */
+    enum Method { PM_UNDO, PM_COPY };
+
+    /*
+    Create a Perft counter using PM_UNDO.
+    */
+    Perft();
+
+    /*
+    Select how moves are explored.
+    */
+    void setMethod(Method method);
+
+    /*
+    Return the number of sequences of `depth` legal moves from the game's current state.
+    */
+    unsigned long long count(Game& game, unsigned int depth);
+
+    /*
+    Return the number of sequences of `depth` legal moves starting with each column in turn (0 for an illegal first
+    move), one entry per column of the game's grid. The total is the same as `count`. An empty vector is returned for a
+    game that is not in progress, or a depth of 0.
+    */
+    std::vector<unsigned long long> divide(Game& game, unsigned int depth);
+
+    /*
+    Return the number of moves played by the counts so far, which is the number of nodes visited other than the
+    starting positions.
+    */
+    unsigned long long movesPlayed() const;
+
+private:
+    // Count from `game`, which is in progress, with depth > 0
+    unsigned long long search(Game& game, unsigned int depth);
+
+    // Count the sequences of `depth` moves starting with `column`, leaving the game as it was
+    unsigned long long searchColumn(Game& game, unsigned int column, unsigned int depth);
+
+    // Set up `game` for counting from, returning either the game itself or a copy played by the stand-in players
+    Game* prepare(Game& game);
+
+    Method method;
+    bool copying;               // whether the current count copies the game before each move
+    unsigned long long moves;
+    Player standInOne;
+    Player standInTwo;
+};
+
+#endif /* end of include guard: PERFT_HPP */
@@ -19,10 +19,20 @@ void Player::resetScore(){
 	score = 0;
 }
 
+void Player::setScore(unsigned int score){
+	this->score = score;
+}
+
 void Player::increaseScore(){
 	score++;
 }
 
+void Player::decreaseScore(){
+	if(score > 0){
+		score--;
+	}
+}
+
 unsigned int Player::getWins() const{
 	return wins;
 }
@@ -30,3 +40,9 @@ unsigned int Player::getWins() const{
 void Player::increaseWins(){
 	wins++;
 }
+
+void Player::decreaseWins(){
+	if(wins > 0){
+		wins--;
+	}
+}
@@ -33,11 +33,21 @@ public:
 	 */
 	void resetScore();
 
+	/*
+    Set this Player's score.
+	 */
+	void setScore(unsigned int score);
+
 	/*
     Increase this Player's score by 1.
 	 */
 	void increaseScore();
 
+	/*
+    Decrease this Player's score by 1, unless it is already 0.
+	 */
+	void decreaseScore();
+
 	/*
     Get this Player's win count.
 	 */
@@ -47,6 +57,11 @@ public:
 	 */
 	void increaseWins();
 
+	/*
+    Decrease this Player's win count by 1, unless it is already 0.
+	 */
+	void decreaseWins();
+
 private:
 	/*
     Private Player copy constructor - players cannot be copied, must be passed around via pointers and references.
@@ -0,0 +1,130 @@
+#include "Playout.hpp"
+
+// Four in a row in `bits`, for a bitboard whose columns are `stride` bits apart (see Position::hasFour)
+static inline bool hasFourWithStride(uint64_t bits, unsigned int stride){
+	uint64_t pairs = bits & (bits >> 1);
+	if(pairs & (pairs >> 2)){
+		return true;
+	}
+	pairs = bits & (bits >> stride);
+	if(pairs & (pairs >> (2 * stride))){
+		return true;
+	}
+	pairs = bits & (bits >> (stride - 1));
+	if(pairs & (pairs >> (2 * (stride - 1)))){
+		return true;
+	}
+	pairs = bits & (bits >> (stride + 1));
+	return (pairs & (pairs >> (2 * (stride + 1)))) != 0;
+}
+
+Playout::Playout(uint64_t seed){
+	this->seed(seed);
+	rows = 0;
+	columns = 0;
+	stride = 0;
+	lastMoves = 0;
+}
+
+void Playout::seed(uint64_t value){
+	// Scramble the seed (splitmix64) so that neighbouring seeds give unrelated games
+	uint64_t z = value + 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	state = (z ^ (z >> 31)) | 1;	// xorshift must never be left at zero
+}
+
+void Playout::prepare(const Position& position){
+	rows = position.rowCount();
+	columns = position.columnCount();
+	stride = rows + 1;
+	for(unsigned int c = 0; c < columns; c++){
+		bottomMasks[c] = (uint64_t)1 << (c * stride);
+		columnMasks[c] = position.columnMask(c);
+	}
+}
+
+template <unsigned int Stride>
+Grid::Cell Playout::playWithStride(const Position& position){
+	const unsigned int step = Stride != 0 ? Stride : stride;
+	uint64_t current = position.currentDiscs();
+	uint64_t mask = position.occupied();
+	unsigned int moves = position.moveCount();
+
+	// The masks of the open columns, so a pick leads straight to the masks without looking the column up
+	uint64_t openBottoms[16];
+	uint64_t openColumns[16];
+	unsigned int openCount = 0;
+	for(unsigned int c = 0; c < columns; c++){
+		if(position.canPlay(c)){
+			openBottoms[openCount] = bottomMasks[c];
+			openColumns[openCount++] = columnMasks[c];
+		}
+	}
+
+	uint64_t random = state;
+	uint64_t bits = 0;
+	unsigned int picksLeft = 0;
+	Grid::Cell winner = Grid::GC_EMPTY;
+	while(openCount > 0){
+		if(picksLeft == 0){
+			// xorshift64*, each output giving four 16-bit picks
+			random ^= random >> 12;
+			random ^= random << 25;
+			random ^= random >> 27;
+			bits = random * 0x2545F4914F6CDD1DULL;
+			picksLeft = 4;
+		}
+		unsigned int pick = (unsigned int)(((bits & 0xFFFF) * openCount) >> 16);
+		bits >>= 16;
+		picksLeft--;
+
+		// Adding the column's bottom bit to the occupied cells carries up to the first empty cell
+		uint64_t move = (mask + openBottoms[pick]) & openColumns[pick];
+		current |= move;
+		mask |= move;
+		moves++;
+		if(hasFourWithStride(current, step)){
+			// Player One makes the first, third, ... moves
+			winner = (moves % 2 == 1) ? Grid::GC_PLAYER_ONE : Grid::GC_PLAYER_TWO;
+			break;
+		}
+		if(((move << 1) & openColumns[pick]) == 0){
+			// the disc filled the column's top cell, so the last open column takes its place
+			openCount--;
+			openBottoms[pick] = openBottoms[openCount];
+			openColumns[pick] = openColumns[openCount];
+		}
+		current ^= mask;
+	}
+	state = random;
+	lastMoves = moves;
+	return winner;
+}
+
+Grid::Cell Playout::play(const Position& position){
+	if(position.rowCount() != rows || position.columnCount() != columns){
+		prepare(position);
+	}
+	switch(stride){
+	case 5:
+		return playWithStride<5>(position);
+	case 6:
+		return playWithStride<6>(position);
+	case 7:
+		return playWithStride<7>(position);
+	case 8:
+		return playWithStride<8>(position);
+	case 9:
+		return playWithStride<9>(position);
+	default:
+		return playWithStride<0>(position);
+	}
+}
+
+void Playout::playMany(const Position& position, unsigned long long count, unsigned long long wins[3]){
+	for(unsigned long long i = 0; i < count; i++){
+		Grid::Cell winner = play(position);
+		wins[winner == Grid::GC_PLAYER_ONE ? 0 : (winner == Grid::GC_PLAYER_TWO ? 1 : 2)]++;
+	}
+}
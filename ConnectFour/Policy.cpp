@@ -0,0 +1,238 @@
+#include "Policy.hpp"
+#include "OpeningBook.hpp"
+#include <algorithm>
+#include <typeinfo>
+
+Policy* Policy::create(const std::string& name){
+	if(name == "random"){
+		return new RandomPolicy();
+	} else if(name == "centre"){
+		return new CentrePolicy();
+	} else if(name == "greedy"){
+		return new GreedyPolicy();
+	} else if(name == "solver"){
+		return new SolverPolicy();
+	} else if(name == "mcts"){
+		return new MctsPolicy();
+	} else if(name == "deepening"){
+		return new DeepeningPolicy();
+	}
+	return 0;
+}
+
+Policy::Policy(){
+	seed(0);
+}
+
+Policy::~Policy(){
+}
+
+void Policy::seed(uint64_t value){
+	// Scramble the seed (splitmix64) so that neighbouring seeds give unrelated sequences
+	uint64_t z = value + 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	state = (z ^ (z >> 31)) | 1;	// xorshift must never be left at zero
+}
+
+void Policy::setBook(const OpeningBook* book){
+}
+
+unsigned int Policy::random(unsigned int bound){
+	// xorshift64*, scaled into range using its high bits
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	uint64_t bits = (state * 0x2545F4914F6CDD1DULL) >> 32;
+	return (unsigned int)((bits * bound) >> 32);
+}
+
+unsigned int Policy::randomColumn(const Grid& grid, bool weighted){
+	// Columns are weighted by their distance from the nearer edge, so the centre is picked most often
+	unsigned int columns = grid.columnCount();
+	unsigned int total = 0;
+	for(unsigned int i = 0; i < columns; i++){
+		if(!grid.isColumnFull(i)){
+			total += weighted ? std::min(i, columns - 1 - i) + 1 : 1;
+		}
+	}
+	unsigned int pick = random(total);
+	for(unsigned int i = 0; i < columns; i++){
+		if(!grid.isColumnFull(i)){
+			unsigned int weight = weighted ? std::min(i, columns - 1 - i) + 1 : 1;
+			if(pick < weight){
+				return i;
+			}
+			pick -= weight;
+		}
+	}
+	return 0;
+}
+
+std::string RandomPolicy::name() const{
+	return "random";
+}
+
+bool Policy::bookColumn(const OpeningBook* book, const Game& game, Grid::Cell disc, unsigned int& column){
+	const Grid& grid = *game.grid();
+	// A SuperGame clears lines and plays on, and other win lengths score differently, so the book doesn't apply
+	if(book == 0 || typeid(game) != typeid(Game) || game.winLength() != 4 || grid.rowCount() != book->rowCount()
+		|| grid.columnCount() != book->columnCount() || !Position::fits(grid.rowCount(), grid.columnCount())){
+		return false;
+	}
+	Position position(grid);
+	Grid::Cell toMove = position.moveCount() % 2 == 0 ? Grid::GC_PLAYER_ONE : Grid::GC_PLAYER_TWO;
+	int score;
+	int move;
+	if(toMove != disc || !book->probe(position, score, move) || move < 0 || grid.isColumnFull(move)){
+		return false;
+	}
+	column = move;
+	return true;
+}
+
+unsigned int RandomPolicy::chooseColumn(const Game& game, Grid::Cell disc){
+	return randomColumn(*game.grid(), false);
+}
+
+std::string CentrePolicy::name() const{
+	return "centre";
+}
+
+unsigned int CentrePolicy::chooseColumn(const Game& game, Grid::Cell disc){
+	const Grid& grid = *game.grid();
+	// Twice the distance from the centre, so even widths don't need fractions
+	unsigned int columns = grid.columnCount();
+	unsigned int best = 0;
+	unsigned int bestDistance = 0;
+	unsigned int ties = 0;
+	for(unsigned int i = 0; i < columns; i++){
+		if(grid.isColumnFull(i)){
+			continue;
+		}
+		unsigned int distance = (2 * i + 1 > columns) ? 2 * i + 1 - columns : columns - 2 * i - 1;
+		if(ties == 0 || distance < bestDistance){
+			best = i;
+			bestDistance = distance;
+			ties = 1;
+		} else if(distance == bestDistance && random(++ties) == 0){
+			best = i;
+		}
+	}
+	return best;
+}
+
+std::string GreedyPolicy::name() const{
+	return "greedy";
+}
+
+unsigned int GreedyPolicy::winningColumn(Grid& grid, Grid::Cell disc, unsigned int length){
+	// Try the disc in every column, taking it out again straight afterwards
+	for(unsigned int i = 0; i < grid.columnCount(); i++){
+		if(grid.insertDisc(i, disc)){
+			unsigned int row = grid.rowCount() - grid.columnHeight(i);
+			bool wins = grid.connectsLine(row, i, disc, length);
+			grid.removeDisc(i);
+			if(wins){
+				return i;
+			}
+		}
+	}
+	return grid.columnCount();
+}
+
+unsigned int GreedyPolicy::chooseColumn(const Game& game, Grid::Cell disc){
+	Grid grid(*game.grid());
+	unsigned int column = winningColumn(grid, disc, game.winLength());
+	if(column == grid.columnCount()){
+		Grid::Cell opponent = disc == Grid::GC_PLAYER_ONE ? Grid::GC_PLAYER_TWO : Grid::GC_PLAYER_ONE;
+		column = winningColumn(grid, opponent, game.winLength());
+	}
+	if(column == grid.columnCount()){
+		column = randomColumn(grid, true);
+	}
+	return column;
+}
+
+SolverPolicy::SolverPolicy(unsigned long long nodes, unsigned int megabytes){
+	solver.setNodeLimit(nodes);
+	solver.setTableSize(megabytes);
+}
+
+void SolverPolicy::setBook(const OpeningBook* book){
+	solver.setBook(book);
+}
+
+std::string SolverPolicy::name() const{
+	return "solver";
+}
+
+unsigned int SolverPolicy::chooseColumn(const Game& game, Grid::Cell disc){
+	const Grid& grid = *game.grid();
+	if(game.winLength() == 4 && Position::fits(grid.rowCount(), grid.columnCount())){
+		// A Position works out whose turn it is from the disc counts, which discs cleared in a SuperGame can upset
+		Position position(grid);
+		Grid::Cell toMove = position.moveCount() % 2 == 0 ? Grid::GC_PLAYER_ONE : Grid::GC_PLAYER_TWO;
+		if(toMove == disc){
+			Solver::Result result = solver.solve(position);
+			if(result.column >= 0){
+				return result.column;
+			}
+		}
+	}
+	return GreedyPolicy::chooseColumn(game, disc);
+}
+
+MctsPolicy::MctsPolicy(unsigned long long iterations, unsigned int rolloutLimit){
+	search.setIterationLimit(iterations);
+	search.setRolloutLimit(rolloutLimit);
+	book = 0;
+}
+
+void MctsPolicy::setBook(const OpeningBook* book){
+	this->book = book;
+}
+
+std::string MctsPolicy::name() const{
+	return "mcts";
+}
+
+unsigned int MctsPolicy::chooseColumn(const Game& game, Grid::Cell disc){
+	unsigned int column;
+	if(bookColumn(book, game, disc, column)){
+		return column;
+	}
+	// Draw the rollouts from the policy's own generator, so seeding the policy seeds the search
+	search.seed(((uint64_t)random(1 << 30) << 30) ^ random(1 << 30));
+	MonteCarlo::Result result = search.search(game);
+	if(result.column >= 0){
+		return result.column;
+	}
+	return randomColumn(*game.grid(), false);
+}
+
+DeepeningPolicy::DeepeningPolicy(unsigned int depth, unsigned int milliseconds){
+	search.setDepthLimit(depth);
+	search.timing().setMoveTime(milliseconds);
+	book = 0;
+}
+
+void DeepeningPolicy::setBook(const OpeningBook* book){
+	this->book = book;
+}
+
+std::string DeepeningPolicy::name() const{
+	return "deepening";
+}
+
+unsigned int DeepeningPolicy::chooseColumn(const Game& game, Grid::Cell disc){
+	unsigned int column;
+	if(bookColumn(book, game, disc, column)){
+		return column;
+	}
+	IterativeDeepening::Result result = search.search(game);
+	if(result.column >= 0){
+		return result.column;
+	}
+	return randomColumn(*game.grid(), true);
+}
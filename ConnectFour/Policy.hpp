@@ -0,0 +1,180 @@
+#ifndef POLICY_HPP
+#define POLICY_HPP
+
+#include "Game.hpp"
+#include "IterativeDeepening.hpp"
+#include "MonteCarlo.hpp"
+#include "Solver.hpp"
+#include <stdint.h>
+#include <string>
+
+/*
+A Policy chooses the moves of one side of a Game without any human input, so games can be played automatically (e.g. by
+a Tournament). Policies are created by name with `Policy::create`:
+
+    random    - a uniformly random playable column
+    centre    - the playable column closest to the centre, breaking ties at random
+    greedy    - a winning move if there is one, otherwise a move blocking the opponent's immediate win, otherwise a
+                random column weighted towards the centre
+    solver    - the best move found by a Solver within a small node budget, falling back to greedy when the grid is
+                too large for a Position. The solver assumes standard Connect Four rules, even in a SuperGame.
+                Positions held in an opening book given with `setBook` are played from the book.
+    mcts      - the move a MonteCarlo tree search picks within a fixed number of iterations, for any grid size and for
+                SuperGame, reusing its tree from one move to the next
+    deepening - the move an IterativeDeepening search picks within a fixed depth, for any grid size and for SuperGame
+
+The mcts and deepening policies also play from an opening book given with `setBook`, but only in standard four in a row
+Games of the book's size, whose positions are the ones the book was solved for.
+
+Every policy that makes random choices draws them from its own generator, so a policy gives the same moves every time it
+is seeded the same way. A Policy instance must only be used by one thread at a time.
+*/
+class Policy {
+public:
+    /*
+    Create the policy with the given name, or return a null pointer (0) if there is no such policy. The caller owns the
+    returned policy.
+    */
+    static Policy* create(const std::string& name);
+
+    virtual ~Policy();
+
+    /*
+    Return the name of the policy, as accepted by `create`.
+    */
+    virtual std::string name() const = 0;
+
+    /*
+    Choose a column for `disc` to play in the given game, which must be in progress. The chosen column is never full.
+    */
+    virtual unsigned int chooseColumn(const Game& game, Grid::Cell disc) = 0;
+
+    /*
+    Restart the policy's random number generator from the given seed.
+    */
+    void seed(uint64_t value);
+
+    /*
+    Give the policy an opening book to consult before searching, or take it away if `book` is null (0). Policies that
+    don't search ignore the book. The book must stay open while the policy is in use.
+    */
+    virtual void setBook(const OpeningBook* book);
+
+protected:
+    Policy();
+
+    // Random number in [0, bound)
+    unsigned int random(unsigned int bound);
+
+    // Random playable column of the grid, favouring columns closer to the centre when `weighted` is set
+    unsigned int randomColumn(const Grid& grid, bool weighted);
+
+    // Look the game up in the book (which may be null), setting `column` to the book's move for `disc`. Returns `false`
+    // unless the game is a standard four in a row Game (not a SuperGame) of the book's size, it is `disc`'s turn and
+    // the position is in the book
+    static bool bookColumn(const OpeningBook* book, const Game& game, Grid::Cell disc, unsigned int& column);
+
+private:
+    /*
+    Private copy constructor and assignment operator - policies are used through pointers.
+    */
+    Policy(const Policy&);
+    Policy& operator=(const Policy&);
+
+    uint64_t state;
+};
+
+/*
+Plays a uniformly random playable column.
+*/
+class RandomPolicy : public Policy {
+public:
+    std::string name() const;
+    unsigned int chooseColumn(const Game& game, Grid::Cell disc);
+};
+
+/*
+Plays the playable column closest to the centre, breaking ties at random.
+*/
+class CentrePolicy : public Policy {
+public:
+    std::string name() const;
+    unsigned int chooseColumn(const Game& game, Grid::Cell disc);
+};
+
+/*
+Takes an immediate win, otherwise blocks the opponent's immediate win, otherwise plays a random column weighted towards
+the centre.
+*/
+class GreedyPolicy : public Policy {
+public:
+    std::string name() const;
+    unsigned int chooseColumn(const Game& game, Grid::Cell disc);
+
+private:
+    // Column where `disc` would complete `length` in a row, or the column count if there is none
+    static unsigned int winningColumn(Grid& grid, Grid::Cell disc, unsigned int length);
+};
+
+/*
+Plays the best move a Solver finds within a node budget, and plays like GreedyPolicy on grids too large to solve or in
+games with a win length other than four.
+*/
+class SolverPolicy : public GreedyPolicy {
+public:
+    /*
+    Create the policy with a node budget per move and a transposition table of the given size in megabytes.
+    */
+    SolverPolicy(unsigned long long nodes = 20000, unsigned int megabytes = 4);
+
+    std::string name() const;
+    unsigned int chooseColumn(const Game& game, Grid::Cell disc);
+    void setBook(const OpeningBook* book);
+
+private:
+    Solver solver;
+};
+
+/*
+Plays the move a MonteCarlo search picks within a fixed number of iterations, with rollouts cut short after a number of
+moves so big grids stay affordable. The search's tree is kept from one move to the next. Positions held in an opening
+book are played from the book without searching.
+*/
+class MctsPolicy : public Policy {
+public:
+    /*
+    Create the policy with a number of iterations per move and a rollout limit in moves (see MonteCarlo).
+    */
+    MctsPolicy(unsigned long long iterations = 2000, unsigned int rolloutLimit = 200);
+
+    std::string name() const;
+    unsigned int chooseColumn(const Game& game, Grid::Cell disc);
+    void setBook(const OpeningBook* book);
+
+private:
+    MonteCarlo search;
+    const OpeningBook* book;
+};
+
+/*
+Plays the move an IterativeDeepening search picks, searching to a fixed depth and, when given one, stopping at a time
+limit per move. Without a time limit the moves only depend on the game. Positions held in an opening book are played
+from the book without searching.
+*/
+class DeepeningPolicy : public Policy {
+public:
+    /*
+    Create the policy with a depth limit and a time limit per move in milliseconds (0 for none).
+    */
+    DeepeningPolicy(unsigned int depth = 6, unsigned int milliseconds = 0);
+
+    std::string name() const;
+    unsigned int chooseColumn(const Game& game, Grid::Cell disc);
+    void setBook(const OpeningBook* book);
+
+private:
+    IterativeDeepening search;
+    const OpeningBook* book;
+};
+
+#endif /* end of include guard: POLICY_HPP */
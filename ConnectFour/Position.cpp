@@ -0,0 +1,166 @@
+#include "Position.hpp"
+
+bool Position::fits(unsigned int rows, unsigned int columns){
+	// Grid dimensions are never smaller than 4
+	if(rows < 4){
+		rows = 4;
+	}
+	if(columns < 4){
+		columns = 4;
+	}
+	return (rows + 1) * columns <= 64;
+}
+
+bool Position::fromMoves(unsigned int rows, unsigned int columns, const std::string& moves, Position& position){
+	position = Position(rows, columns);
+	if(moves == "-"){
+		return true;
+	}
+	for(unsigned int i = 0; i < moves.size(); i++){
+		unsigned int column = moves[i] - '1';
+		if(moves[i] < '1' || !position.canPlay(column) || position.isWinningMove(column)){
+			return false;
+		}
+		position.play(column);
+	}
+	return true;
+}
+
+Position::Position(unsigned int rows, unsigned int columns){
+	// Adjusting for boundaries in the same way as the Grid
+	this->rows = (rows < 4) ? 4 : rows;
+	this->columns = (columns < 4) ? 4 : columns;
+	stride = this->rows + 1;
+	current = 0;
+	mask = 0;
+	moves = 0;
+	bottom = 0;
+	for(unsigned int c = 0; c < this->columns; c++){
+		bottom |= bottomMask(c);
+	}
+	board = bottom * ((((uint64_t)1) << this->rows) - 1);
+}
+
+Position::Position(const Grid& grid){
+	if(!fits(grid.rowCount(), grid.columnCount())){
+		*this = Position();
+		return;
+	}
+	*this = Position(grid.rowCount(), grid.columnCount());
+	// A grid that fits stores each player's discs in a single word laid out exactly like a Position
+	uint64_t discs[2] = { grid.bitboard(Grid::GC_PLAYER_ONE), grid.bitboard(Grid::GC_PLAYER_TWO) };
+	unsigned int counts[2] = { Grid::countBits(discs[0]), Grid::countBits(discs[1]) };
+	mask = discs[0] | discs[1];
+	moves = counts[0] + counts[1];
+	// Player One moves first, so it is their turn whenever both players have played the same number of discs
+	current = (counts[0] == counts[1]) ? discs[0] : discs[1];
+}
+
+Position::Position(unsigned int rows, unsigned int columns, uint64_t key){
+	*this = Position(rows, columns);
+	// Each column of a key holds (2^h - 1) plus the discs of the player to move for a column of height h, so the
+	// column's highest set bit sits just above its top disc
+	uint64_t columnBits = ((uint64_t)1 << stride) - 1;
+	for(unsigned int c = 0; c < this->columns; c++){
+		uint64_t value = (key >> (c * stride)) & columnBits;
+		unsigned int height = 0;
+		while((value + 1) >> (height + 1)){
+			height++;
+		}
+		uint64_t filled = ((uint64_t)1 << height) - 1;
+		mask |= filled << (c * stride);
+		current |= (value - filled) << (c * stride);
+		moves += height;
+	}
+}
+
+uint64_t Position::mirroredKey() const{
+	// A key keeps every column's bits within that column, so the columns can simply be swapped around
+	uint64_t key = this->key();
+	uint64_t column = ((uint64_t)1 << stride) - 1;
+	uint64_t mirrored = 0;
+	for(unsigned int c = 0; c < columns; c++){
+		mirrored |= ((key >> (c * stride)) & column) << ((columns - 1 - c) * stride);
+	}
+	return mirrored;
+}
+
+Grid::Cell Position::cellAt(unsigned int row, unsigned int column) const{
+	if(row >= rows || column >= columns){
+		return Grid::GC_EMPTY;
+	}
+	uint64_t bit = (uint64_t)1 << (column * stride + rows - 1 - row);
+	if((mask & bit) == 0){
+		return Grid::GC_EMPTY;
+	}
+	// The player to move is Player One after an even number of moves
+	bool currentIsOne = (moves % 2 == 0);
+	bool isCurrent = (current & bit) != 0;
+	return (isCurrent == currentIsOne) ? Grid::GC_PLAYER_ONE : Grid::GC_PLAYER_TWO;
+}
+
+uint64_t Position::possibleNonLosingMoves() const{
+	uint64_t playable = possible();
+	uint64_t opponentWins = winningPositions(current ^ mask);
+	uint64_t forced = playable & opponentWins;
+	if(forced){
+		// More than one cell to block means the opponent wins whatever we play
+		if(forced & (forced - 1)){
+			return 0;
+		}
+		playable = forced;
+	}
+	// Never play directly below a cell where the opponent would complete four
+	return playable & ~(opponentWins >> 1);
+}
+
+int Position::moveScore(uint64_t move) const{
+	uint64_t threats = winningPositions(current | move);
+	int count = 0;
+	for(; threats; count++){
+		threats &= threats - 1;
+	}
+	return count;
+}
+
+unsigned int Position::columnOf(uint64_t move) const{
+	unsigned int bit = 0;
+	while((move >> bit) > 1){
+		bit++;
+	}
+	return bit / stride;
+}
+
+bool Position::hasFour(uint64_t bits, unsigned int stride){
+	// vertical, horizontal and both diagonals
+	unsigned int steps[4] = { 1, stride, stride - 1, stride + 1 };
+	for(unsigned int i = 0; i < 4; i++){
+		uint64_t pairs = bits & (bits >> steps[i]);
+		if(pairs & (pairs >> (2 * steps[i]))){
+			return true;
+		}
+	}
+	return false;
+}
+
+uint64_t Position::winningPositions() const{
+	return winningPositions(current);
+}
+
+uint64_t Position::winningPositions(uint64_t discs) const{
+	// vertical: three discs directly below
+	uint64_t r = (discs << 1) & (discs << 2) & (discs << 3);
+
+	// horizontal and both diagonals: for each step, look for gaps with three discs around them in a line
+	unsigned int steps[3] = { stride, (unsigned int)stride - 1, (unsigned int)stride + 1 };
+	for(unsigned int i = 0; i < 3; i++){
+		unsigned int s = steps[i];
+		uint64_t p = (discs << s) & (discs << (2 * s));
+		r |= p & (discs << (3 * s));
+		r |= p & (discs >> s);
+		p = (discs >> s) & (discs >> (2 * s));
+		r |= p & (discs << s);
+		r |= p & (discs >> (3 * s));
+	}
+	return r & (board ^ mask);
+}
@@ -0,0 +1,202 @@
+#ifndef POSITION_HPP
+#define POSITION_HPP
+
+#include <stdint.h>
+#include <string>
+#include "Grid.hpp"
+
+/*
+The Position class is a compact snapshot of a Connect Four grid, used by the search engines where a full Grid would be
+too slow to copy and update. It only supports grids small enough that (rows + 1) * columns <= 64, which covers the
+standard 6x7 grid and anything up to 7x8 or 8x7.
+
+The cells are stored in the same bitboard layout as the Grid: each column takes (rows + 1) bits starting from the bottom
+row, with the top bit of each column always left clear. Rather than storing one bitboard per player, a Position stores
+the discs of the player whose turn it is (`current`) along with a mask of every occupied cell, so playing a move only
+needs a couple of bit operations and the key of a position is unique without hashing.
+
+Player One always moves first, so the player to move is Player One whenever an even number of moves has been played.
+*/
+class Position {
+public:
+    /*
+    Return `true` if a grid of the given dimensions fits into a Position.
+    */
+    static bool fits(unsigned int rows, unsigned int columns);
+
+    /*
+    Set `position` to the Position of the given dimensions reached by playing `moves` from the empty grid. The moves
+    are written as the command line tools read them: the columns played, numbered from 1 (e.g. "4453"), or "-" for
+    none. Returns `false` if a move can't be played or would win the game, as positions where the game is over have no
+    value to look up.
+    */
+    static bool fromMoves(unsigned int rows, unsigned int columns, const std::string& moves, Position& position);
+
+    /*
+    Create an empty Position with the given number of rows and columns. The dimensions are corrected to be at least 4
+    in the same way as for a Grid, and must satisfy `fits`.
+    */
+    Position(unsigned int rows = 6, unsigned int columns = 7);
+
+    /*
+    Create a Position holding the same discs as the given Grid. The grid must satisfy `fits`, otherwise the result is an
+    empty 6x7 Position. The player to move is worked out from the number of discs each player has on the grid.
+    */
+    explicit Position(const Grid& grid);
+
+    /*
+    Create the Position of the given dimensions whose key (see `key`) is `key`. The key must come from a Position of
+    the same dimensions.
+    */
+    Position(unsigned int rows, unsigned int columns, uint64_t key);
+
+    /*
+    Return the number of rows in the position.
+    */
+    unsigned int rowCount() const { return rows; }
+
+    /*
+    Return the number of columns in the position.
+    */
+    unsigned int columnCount() const { return columns; }
+
+    /*
+    Return the number of moves played to reach this position.
+    */
+    unsigned int moveCount() const { return moves; }
+
+    /*
+    Return the value of the cell at the specified row and column (row 0 being the top of the grid), from the point of
+    view of the players rather than the player to move. Returns GC_EMPTY for cells outside the position.
+    */
+    Grid::Cell cellAt(unsigned int row, unsigned int column) const;
+
+    /*
+    Return `true` if a disc can be played into the specified column.
+    */
+    bool canPlay(unsigned int column) const {
+        return column < columns && (mask & topMask(column)) == 0;
+    }
+
+    /*
+    Play a disc for the player to move into the specified column. The column must be playable (see `canPlay`).
+    */
+    void play(unsigned int column) {
+        playMove((mask + bottomMask(column)) & columnMask(column));
+    }
+
+    /*
+    Play the move given as a single bit of the bitboard (as returned by `possible`).
+    */
+    void playMove(uint64_t move) {
+        current ^= mask;
+        mask |= move;
+        moves++;
+    }
+
+    /*
+    Return `true` if playing into the specified column wins the game for the player to move.
+    */
+    bool isWinningMove(unsigned int column) const {
+        return (winningPositions() & possible() & columnMask(column)) != 0;
+    }
+
+    /*
+    Return `true` if the player to move can win with their next move.
+    */
+    bool canWinNext() const {
+        return (winningPositions() & possible()) != 0;
+    }
+
+    /*
+    Return `true` if the player who made the last move has four in a row.
+    */
+    bool lastMoveWon() const {
+        return hasFour(current ^ mask, stride);
+    }
+
+    /*
+    Return a bitboard with one bit set for the cell each playable column's next disc would land on.
+    */
+    uint64_t possible() const {
+        return (mask + bottom) & board;
+    }
+
+    /*
+    Return the playable moves that do not hand the opponent an immediate win, assuming the player to move cannot win
+    straight away. Returns 0 if every move loses.
+    */
+    uint64_t possibleNonLosingMoves() const;
+
+    /*
+    Return a score used to order moves: the number of cells where the player to move would threaten to complete four
+    in a row after playing `move`.
+    */
+    int moveScore(uint64_t move) const;
+
+    /*
+    Return a key that uniquely identifies this position among positions of the same dimensions.
+    */
+    uint64_t key() const {
+        return current + mask;
+    }
+
+    /*
+    Return the key of this position's mirror image, with the columns in reverse order. A position and its mirror image
+    have the same value, so tables can store them once.
+    */
+    uint64_t mirroredKey() const;
+
+    /*
+    Return the bitboard of the discs belonging to the player to move.
+    */
+    uint64_t currentDiscs() const { return current; }
+
+    /*
+    Return the bitboard of every occupied cell.
+    */
+    uint64_t occupied() const { return mask; }
+
+    /*
+    Return the column containing the (single bit) move, as returned by `possible`.
+    */
+    unsigned int columnOf(uint64_t move) const;
+
+    /*
+    Return a bitboard with every cell of the specified column set.
+    */
+    uint64_t columnMask(unsigned int column) const {
+        return (((uint64_t)1 << rows) - 1) << (column * stride);
+    }
+
+    /*
+    Return `true` if `bits` contains four in a row, for a bitboard whose columns are `stride` bits apart.
+    */
+    static bool hasFour(uint64_t bits, unsigned int stride);
+
+private:
+    uint64_t topMask(unsigned int column) const {
+        return (uint64_t)1 << (rows - 1 + column * stride);
+    }
+
+    uint64_t bottomMask(unsigned int column) const {
+        return (uint64_t)1 << (column * stride);
+    }
+
+    // Empty cells that would complete four in a row for the player to move
+    uint64_t winningPositions() const;
+
+    // Empty cells that would complete four in a row for the player owning `discs`
+    uint64_t winningPositions(uint64_t discs) const;
+
+    uint64_t current;   // discs of the player to move
+    uint64_t mask;      // every occupied cell
+    uint64_t bottom;    // bottom cell of every column
+    uint64_t board;     // every cell of the grid
+    unsigned char rows;
+    unsigned char columns;
+    unsigned char stride;
+    unsigned char moves;
+};
+
+#endif /* end of include guard: POSITION_HPP */
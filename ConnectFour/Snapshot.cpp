@@ -0,0 +1,44 @@
+#include "Snapshot.hpp"
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<Snapshot>::value, "a Snapshot must copy with a memcpy");
+
+Snapshot::Snapshot(){
+	boards[0] = 0;
+	boards[1] = 0;
+	scores[0] = 0;
+	scores[1] = 0;
+	rows = 0;
+	columns = 0;
+	turn = 0;
+	gameStatus = Game::GS_INVALID;
+	lineLength = 4;
+}
+
+Grid::Cell Snapshot::cellAt(unsigned int row, unsigned int column) const{
+	if(row >= rows || column >= columns){
+		return Grid::GC_EMPTY;
+	}
+	// Same layout as the Grid: columns of (rows + 1) bits from the bottom row up
+	uint64_t bit = (uint64_t)1 << (column * (rows + 1) + rows - 1 - row);
+	if(boards[0] & bit){
+		return Grid::GC_PLAYER_ONE;
+	} else if(boards[1] & bit){
+		return Grid::GC_PLAYER_TWO;
+	}
+	return Grid::GC_EMPTY;
+}
+
+uint64_t Snapshot::bitboard(Grid::Cell disc) const{
+	if(disc == Grid::GC_EMPTY){
+		return 0;
+	}
+	return boards[disc == Grid::GC_PLAYER_ONE ? 0 : 1];
+}
+
+unsigned int Snapshot::score(Grid::Cell disc) const{
+	if(disc == Grid::GC_EMPTY){
+		return 0;
+	}
+	return scores[disc == Grid::GC_PLAYER_ONE ? 0 : 1];
+}
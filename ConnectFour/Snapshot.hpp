@@ -0,0 +1,86 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <stdint.h>
+#include "Game.hpp"
+#include "Grid.hpp"
+
+/*
+A Snapshot is a plain value copy of the state of a Game: the discs on its grid, the number of turns played, the game
+status, both players' scores and the win length. It is taken with `Game::snapshot` and turned back into a live game with
+`Game::restore`.
+
+A Snapshot only supports grids small enough that (rows + 1) * columns <= 64 (see `Position::fits`), so the discs are
+held as one bitboard word per player, in the same layout as the Grid, and the whole Snapshot is a few dozen bytes of
+fixed size with no pointers. It is trivially copyable: copying one is a memcpy, so it can be handed to as many threads
+as needed without any allocation or shared ownership.
+
+The players themselves, the win check method and the game's move stack are not part of a Snapshot.
+*/
+class Snapshot {
+public:
+    /*
+    Create an invalid Snapshot, holding no game.
+    */
+    Snapshot();
+
+    /*
+    Return `true` if the Snapshot holds a game. Snapshots of games without a grid, or with a grid too large to fit, are
+    invalid.
+    */
+    bool valid() const { return rows != 0; }
+
+    /*
+    Return the number of rows of the grid, or 0 if the Snapshot is invalid.
+    */
+    unsigned int rowCount() const { return rows; }
+
+    /*
+    Return the number of columns of the grid, or 0 if the Snapshot is invalid.
+    */
+    unsigned int columnCount() const { return columns; }
+
+    /*
+    Return the value of the cell at the specified row and column (row 0 being the top of the grid), or GC_EMPTY for
+    cells outside the grid.
+    */
+    Grid::Cell cellAt(unsigned int row, unsigned int column) const;
+
+    /*
+    Return the bitboard of the given player's discs (see `Grid::bitboard`), or 0 for GC_EMPTY.
+    */
+    uint64_t bitboard(Grid::Cell disc) const;
+
+    /*
+    Return the number of turns played.
+    */
+    unsigned int turnCount() const { return turn; }
+
+    /*
+    Return the game status.
+    */
+    Game::Status status() const { return (Game::Status)gameStatus; }
+
+    /*
+    Return the score of Player One (for GC_PLAYER_ONE) or Player Two (for GC_PLAYER_TWO), or 0 for GC_EMPTY.
+    */
+    unsigned int score(Grid::Cell disc) const;
+
+    /*
+    Return the number of discs in a row needed to win.
+    */
+    unsigned int winLength() const { return lineLength; }
+
+private:
+    friend class Game;
+
+    uint64_t boards[2];         // player one's discs, then player two's
+    uint32_t scores[2];         // player one's score, then player two's
+    uint32_t turn;              // a SuperGame can take more turns than the grid has cells
+    unsigned char rows;
+    unsigned char columns;
+    unsigned char gameStatus;
+    unsigned char lineLength;
+};
+
+#endif /* end of include guard: SNAPSHOT_HPP */
@@ -0,0 +1,388 @@
+#include "Solver.hpp"
+#include "OpeningBook.hpp"
+#include "EndgameDatabase.hpp"
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+/*
+Keeps the moves of a node sorted by score while they are added, so they can be handed back best first. Moves with equal
+scores come back in the reverse order they were added.
+*/
+class MoveSorter {
+public:
+	MoveSorter(){
+		size = 0;
+	}
+
+	void add(uint64_t move, int score){
+		unsigned int pos = size++;
+		for(; pos && entries[pos - 1].score > score; --pos){
+			entries[pos] = entries[pos - 1];
+		}
+		entries[pos].move = move;
+		entries[pos].score = score;
+	}
+
+	// Returns the best remaining move, or 0 once every move has been handed back
+	uint64_t next(){
+		if(size){
+			return entries[--size].move;
+		}
+		return 0;
+	}
+
+private:
+	struct Entry {
+		uint64_t move;
+		int score;
+	};
+	unsigned int size;
+	Entry entries[16];
+};
+
+Solver::Solver(){
+	nodeLimit = 0;
+	timeLimit = 0;
+	threads = 1;
+	nodeTotal = 0;
+	stopped = false;
+	outOfBudget = false;
+	cells = 0;
+	columnCount = 0;
+	tableRows = 0;
+	tableColumns = 0;
+	book = 0;
+	endgames = 0;
+}
+
+void Solver::setTableSize(unsigned int megabytes){
+	table.resize(megabytes);
+}
+
+void Solver::clearTable(){
+	table.clear();
+}
+
+void Solver::setTableReplacement(TranspositionTable::Replacement policy){
+	table.setReplacement(policy);
+}
+
+void Solver::setNodeLimit(unsigned long long nodes){
+	nodeLimit = nodes;
+}
+
+void Solver::setTimeLimit(unsigned int milliseconds){
+	timeLimit = milliseconds;
+}
+
+void Solver::setThreads(unsigned int count){
+	if(count == 0){
+		count = std::thread::hardware_concurrency();
+	}
+	threads = count == 0 ? 1 : count;
+}
+
+void Solver::setBook(const OpeningBook* book){
+	this->book = book;
+}
+
+void Solver::setEndgames(const EndgameDatabase* database){
+	endgames = database;
+}
+
+unsigned int Solver::threadCount() const{
+	return threads;
+}
+
+void Solver::orderColumns(Worker& worker, unsigned int index){
+	// Start in the middle and work outwards, alternating left and right
+	for(unsigned int i = 0; i < columnCount; i++){
+		int offset = (i % 2 == 0) ? (int)(i + 1) / 2 : -(int)(i + 1) / 2;
+		worker.columnOrder[i] = columnCount / 2 + offset;
+	}
+	// Helper threads swap a pair of neighbours in the order, so they don't all walk the tree in lockstep
+	if(index > 0){
+		unsigned int i = (index - 1) % (columnCount - 1);
+		unsigned int swapped = worker.columnOrder[i];
+		worker.columnOrder[i] = worker.columnOrder[i + 1];
+		worker.columnOrder[i + 1] = swapped;
+	}
+}
+
+void Solver::checkBudget(){
+	unsigned long long nodes = nodeTotal.fetch_add(1024, std::memory_order_relaxed) + 1024;
+	bool exceeded = nodeLimit != 0 && nodes >= nodeLimit;
+	if(!exceeded && timeLimit != 0){
+		std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - startTime;
+		exceeded = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() >= timeLimit;
+	}
+	if(exceeded){
+		outOfBudget = true;
+		stopped = true;
+	}
+}
+
+int Solver::negamax(Worker& worker, const Position& position, int alpha, int beta){
+	worker.nodes++;
+	if((worker.nodes & 1023) == 0){
+		checkBudget();
+	}
+	if(stopped.load(std::memory_order_relaxed)){
+		return alpha;	// the result is thrown away, so any value will do
+	}
+	uint64_t next = position.possibleNonLosingMoves();
+	if(next == 0){
+		// every move lets the opponent win straight away
+		return -(int)(cells - position.moveCount()) / 2;
+	}
+	if(position.moveCount() >= cells - 2){
+		// neither player can win with the last two discs
+		return 0;
+	}
+
+	// We can't lose on the opponent's next move, and can't win before our move after that
+	int min = -(int)(cells - 2 - position.moveCount()) / 2;
+	if(alpha < min){
+		alpha = min;
+		if(alpha >= beta){
+			return alpha;
+		}
+	}
+	int max = (int)(cells - 1 - position.moveCount()) / 2;
+	if(beta > max){
+		beta = max;
+		if(alpha >= beta){
+			return beta;
+		}
+	}
+
+	// A database outcome settles a draw, and bounds a win or a loss by a score of 1 or -1
+	EndgameDatabase::Outcome outcome;
+	if(endgames != 0 && endgames->probe(position, outcome)){
+		if(outcome == EndgameDatabase::EO_DRAW){
+			return 0;
+		} else if(outcome == EndgameDatabase::EO_WIN && alpha < 1){
+			alpha = 1;
+		} else if(outcome == EndgameDatabase::EO_LOSS && beta > -1){
+			beta = -1;
+		}
+		if(alpha >= beta){
+			return outcome == EndgameDatabase::EO_WIN ? alpha : beta;
+		}
+	}
+
+	// Use what an earlier search of this position found, narrowing the window or settling the score outright
+	uint64_t key = position.key();
+	unsigned int hintColumn = TranspositionTable::NO_MOVE;
+	TranspositionTable::Entry entry;
+	if(table.probe(key, entry)){
+		if(entry.bound == TranspositionTable::TB_EXACT){
+			return entry.score;
+		} else if(entry.bound == TranspositionTable::TB_LOWER && entry.score > alpha){
+			alpha = entry.score;
+		} else if(entry.bound == TranspositionTable::TB_UPPER && entry.score < beta){
+			beta = entry.score;
+		}
+		if(alpha >= beta){
+			return alpha;
+		}
+		hintColumn = entry.move;
+	}
+	int originalAlpha = alpha;
+	unsigned int depth = cells - position.moveCount();
+
+	// Add the moves outside-in so that, for equal scores, the centre columns come out first. The best move from an
+	// earlier search goes in last with a score no other move can beat, so it's tried first.
+	MoveSorter moves;
+	uint64_t hintMove = 0;
+	for(unsigned int i = columnCount; i-- > 0;){
+		uint64_t move = next & position.columnMask(worker.columnOrder[i]);
+		if(move && worker.columnOrder[i] == hintColumn){
+			hintMove = move;
+		} else if(move){
+			moves.add(move, position.moveScore(move));
+		}
+	}
+	if(hintMove){
+		moves.add(hintMove, 1000);
+	}
+
+	unsigned int bestColumn = TranspositionTable::NO_MOVE;
+	while(uint64_t move = moves.next()){
+		Position child(position);
+		child.playMove(move);
+		int score = -negamax(worker, child, -beta, -alpha);
+		if(stopped.load(std::memory_order_relaxed)){
+			return alpha;
+		}
+		if(score >= beta){
+			table.store(key, score, TranspositionTable::TB_LOWER, depth, position.columnOf(move));
+			return score;
+		}
+		if(score > alpha){
+			alpha = score;
+			bestColumn = position.columnOf(move);
+		}
+	}
+	if(alpha > originalAlpha){
+		table.store(key, alpha, TranspositionTable::TB_EXACT, depth, bestColumn);
+	} else {
+		table.store(key, alpha, TranspositionTable::TB_UPPER, depth, hintColumn);
+	}
+	return alpha;
+}
+
+void Solver::searchScore(Worker& worker, const Position& position){
+	// Narrow down the score with null window searches, biased towards zero where results tend to be
+	int min = -(int)(cells - position.moveCount()) / 2;
+	int max = (cells + 1 - position.moveCount()) / 2;
+	EndgameDatabase::Outcome outcome;
+	if(endgames != 0 && endgames->probe(position, outcome)){
+		min = outcome == EndgameDatabase::EO_WIN ? 1 : outcome == EndgameDatabase::EO_DRAW ? 0 : min;
+		max = outcome == EndgameDatabase::EO_LOSS ? -1 : outcome == EndgameDatabase::EO_DRAW ? 0 : max;
+	}
+	while(min < max){
+		int med = min + (max - min) / 2;
+		if(med <= 0 && min / 2 < med){
+			med = min / 2;
+		} else if(med >= 0 && max / 2 > med){
+			med = max / 2;
+		}
+		int r = negamax(worker, position, med, med + 1);
+		if(stopped){
+			break;
+		}
+		if(r <= med){
+			max = r;
+		} else {
+			min = r;
+		}
+	}
+	worker.score = min;
+	worker.complete = min >= max;
+	if(worker.complete){
+		// let the other threads know they can stop
+		stopped = true;
+	}
+}
+
+Solver::Result Solver::solve(const Position& position){
+	startTime = std::chrono::steady_clock::now();
+	nodeTotal = 0;
+	stopped = false;
+	outOfBudget = false;
+	cells = position.rowCount() * position.columnCount();
+	columnCount = position.columnCount();
+	if(position.rowCount() != tableRows || position.columnCount() != tableColumns){
+		// keys are only unique among positions of the same size
+		table.clear();
+		tableRows = position.rowCount();
+		tableColumns = position.columnCount();
+	}
+	std::vector<Worker> workers(threads);
+	for(unsigned int i = 0; i < threads; i++){
+		workers[i].nodes = 0;
+		workers[i].score = 0;
+		workers[i].complete = false;
+		orderColumns(workers[i], i);
+	}
+	Worker& lead = workers[0];
+
+	Result result;
+	result.column = -1;
+	result.complete = true;
+	if(book != 0 && book->probe(position, result.score, result.column)){
+		// solved ahead of time
+	} else if(position.moveCount() == cells){
+		// full grid, nothing left to play
+		result.score = 0;
+	} else if(position.canWinNext()){
+		// take the win straight away
+		result.score = (cells + 1 - position.moveCount()) / 2;
+		for(unsigned int i = 0; i < columnCount; i++){
+			if(position.canPlay(lead.columnOrder[i]) && position.isWinningMove(lead.columnOrder[i])){
+				result.column = lead.columnOrder[i];
+				break;
+			}
+		}
+	} else {
+		// Every thread searches for the score, and the first to finish stops the rest
+		std::vector<std::thread> helpers;
+		for(unsigned int i = 1; i < threads; i++){
+			helpers.push_back(std::thread(&Solver::searchScore, this, std::ref(workers[i]), std::cref(position)));
+		}
+		searchScore(lead, position);
+		for(unsigned int i = 0; i < helpers.size(); i++){
+			helpers[i].join();
+		}
+		int min = lead.score;
+		result.complete = false;
+		for(unsigned int i = 0; i < threads; i++){
+			if(workers[i].complete){
+				min = workers[i].score;
+				result.complete = true;
+				stopped = outOfBudget.load();
+				break;
+			}
+		}
+		result.score = min;
+
+		// The best move is the first (in search order) whose reply scores no better than -score for the opponent
+		uint64_t next = position.possibleNonLosingMoves();
+		for(unsigned int i = 0; i < columnCount && result.column == -1; i++){
+			unsigned int column = lead.columnOrder[i];
+			if(!position.canPlay(column)){
+				continue;
+			}
+			if(next == 0 || stopped){
+				// every move loses (or we're out of budget), settle for the first legal one
+				if(next == 0 || (next & position.columnMask(column))){
+					result.column = column;
+				}
+				continue;
+			}
+			if((next & position.columnMask(column)) == 0){
+				continue;
+			}
+			Position child(position);
+			child.play(column);
+			if(-negamax(lead, child, -min, -min + 1) >= min && !stopped){
+				result.column = column;
+			}
+		}
+		if(result.column == -1){
+			// the budget ran out while looking for the best move
+			result.complete = false;
+			for(unsigned int i = 0; i < columnCount && result.column == -1; i++){
+				if(position.canPlay(lead.columnOrder[i])){
+					result.column = lead.columnOrder[i];
+				}
+			}
+		}
+	}
+
+	result.nodes = 0;
+	for(unsigned int i = 0; i < threads; i++){
+		result.nodes += workers[i].nodes;
+	}
+	std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - startTime;
+	result.milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+	return result;
+}
+
+Solver::Result Solver::solve(const Game& game){
+	// A Position only plays by the standard rules, so other win lengths and SuperGames can't be solved with one
+	const Grid* grid = game.grid();
+	if(typeid(game) != typeid(Game) || game.winLength() != 4 || game.status() != Game::GS_IN_PROGRESS
+		|| !Position::fits(grid->rowCount(), grid->columnCount())){
+		Result result;
+		result.score = 0;
+		result.column = -1;
+		result.complete = false;
+		result.nodes = 0;
+		result.milliseconds = 0;
+		return result;
+	}
+	return solve(Position(*grid));
+}
@@ -0,0 +1,159 @@
+#ifndef SOLVER_HPP
+#define SOLVER_HPP
+
+#include "Position.hpp"
+#include "Game.hpp"
+#include "TranspositionTable.hpp"
+#include <atomic>
+#include <chrono>
+
+class OpeningBook;
+class EndgameDatabase;
+
+/*
+The Solver computes the game-theoretic value of a Connect Four position, and the best move to play from it, using a
+negamax search with alpha-beta pruning. Moves are tried most promising first: moves that create the most threats of
+four in a row, with ties broken in favour of the columns closest to the centre. Moves that would hand the opponent an
+immediate win are never searched. Results are remembered in a transposition table, so positions reached again through
+a different order of moves are not searched twice, and the best move found for a position is tried first when it is
+searched again. The table is kept between calls to `solve` as long as the grid size doesn't change.
+
+Scores are from the point of view of the player to move. A score of 0 means the game is a draw with perfect play. A
+positive score means the player to move can force a win, and is one more than the number of discs that player still has
+left to play when they win (so winning sooner scores higher). A negative score means the player to move loses, with the
+magnitude counting the same way for the opponent.
+
+A search can be limited to a number of nodes and/or an amount of time. When the budget runs out before the position is
+solved, the result is marked incomplete and holds the best information found so far.
+
+A search can also run on several threads at once (Lazy SMP). Every thread searches the same position with a slightly
+different move order, sharing the transposition table, so each thread mostly finds the work it is about to do already
+done by the others. The score comes from whichever thread finishes first. With a single thread (the default) a search is
+deterministic: the same position always gives the same result and node count.
+
+An OpeningBook can be given to the solver, and positions held in it are answered from the book without any search. An
+EndgameDatabase can be given too: every position searched that it holds has its score narrowed to the database's
+outcome, so drawn positions are settled without a search and the rest only need the size of the win or loss found.
+*/
+class Solver {
+public:
+    /*
+    The Result of a search.
+    */
+    struct Result {
+        int score;                  // value of the position for the player to move (a lower bound if incomplete)
+        int column;                 // best column to play, or -1 if there are no moves to play
+        bool complete;              // false if the search ran out of budget before the position was solved
+        unsigned long long nodes;   // number of positions searched, summed over all threads
+        unsigned int milliseconds;  // time taken by the search
+    };
+
+    /*
+    Create a new Solver without any node or time limit.
+    */
+    Solver();
+
+    /*
+    Limit every search to (roughly) the given number of nodes. A limit of 0 means no limit.
+    */
+    void setNodeLimit(unsigned long long nodes);
+
+    /*
+    Limit every search to (roughly) the given number of milliseconds. A limit of 0 means no limit.
+    */
+    void setTimeLimit(unsigned int milliseconds);
+
+    /*
+    Set the memory budget of the transposition table in megabytes (16 by default), discarding its contents. A size of 0
+    turns the table off.
+    */
+    void setTableSize(unsigned int megabytes);
+
+    /*
+    Discard the contents of the transposition table, keeping its size, so the next search starts from scratch.
+    */
+    void clearTable();
+
+    /*
+    Set the replacement policy of the transposition table.
+    */
+    void setTableReplacement(TranspositionTable::Replacement policy);
+
+    /*
+    Set the number of threads each search runs on. A count of 0 uses one thread per core.
+    */
+    void setThreads(unsigned int count);
+
+    /*
+    Return the number of threads each search runs on.
+    */
+    unsigned int threadCount() const;
+
+    /*
+    Consult the given book before searching any position it holds, or stop consulting a book if `book` is null (0). The
+    book isn't owned by the solver and must stay open while it's in use.
+    */
+    void setBook(const OpeningBook* book);
+
+    /*
+    Consult the given endgame database for every position searched that it holds, or stop consulting a database if
+    `database` is null (0). The database isn't owned by the solver and must stay open while it's in use.
+    */
+    void setEndgames(const EndgameDatabase* database);
+
+    /*
+    Solve the given position. The player who made the last move must not already have four in a row.
+    */
+    Result solve(const Position& position);
+
+    /*
+    Solve the current position of the given game. If the game isn't a standard Game (four in a row to win, so not a
+    SuperGame), is not in progress, or its grid is too large to fit into a Position (see `Position::fits`), the returned
+    result is incomplete and has no column.
+    */
+    Result solve(const Game& game);
+
+private:
+    /*
+    Private copy constructor and assignment operator - the transposition table can't be copied.
+    */
+    Solver(const Solver&);
+    Solver& operator=(const Solver&);
+
+    // The state of a single thread's search
+    struct Worker {
+        unsigned long long nodes;
+        unsigned int columnOrder[16];
+        int score;          // score found by searchScore
+        bool complete;      // whether searchScore finished
+    };
+
+    // Search the position within the window (alpha, beta); the player to move must not be able to win immediately
+    int negamax(Worker& worker, const Position& position, int alpha, int beta);
+
+    // Narrow down the score of the position with null window searches, filling in the worker's score and complete flag
+    void searchScore(Worker& worker, const Position& position);
+
+    // Check the node and time limits, stopping the search once either is exceeded
+    void checkBudget();
+
+    // Fill in the worker's column order: centre-first, varied a little for every worker but the first
+    void orderColumns(Worker& worker, unsigned int index);
+
+    unsigned long long nodeLimit;
+    unsigned int timeLimit;
+    unsigned int threads;
+    std::atomic<unsigned long long> nodeTotal;  // nodes searched by every thread, updated every 1024 nodes
+    std::atomic<bool> stopped;                  // set when the search is out of budget or another thread finished
+    std::atomic<bool> outOfBudget;              // set when the search is out of budget
+    unsigned int cells;
+    unsigned int columnCount;
+    unsigned int tableRows;     // size of the positions currently held by the table
+    unsigned int tableColumns;
+    TranspositionTable table;
+    const OpeningBook* book;
+    const EndgameDatabase* endgames;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+#endif /* end of include guard: SOLVER_HPP */
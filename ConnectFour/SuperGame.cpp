@@ -1,164 +1,128 @@
 #include "SuperGame.hpp"
+#include <algorithm>
 
 bool SuperGame::playNextTurn(unsigned int column){
 	// Does the same at first finds the disc inserted position and look connect 4 combos
 	// If found increases the score of the corresponding player and falls down the discs
 	if(gameStatus == GS_IN_PROGRESS){
-		bool playerOneCombo = false;
-		bool playerTwoCombo = false;
-		if(nextPlayer() == playerOne){
-			if(board->insertDisc(column, Grid::GC_PLAYER_ONE)){
-
-				int j = -1;
-				for(unsigned int i = 0; i < board->rowCount(); i++){
-					if(board->cellAt(i, column) == Grid::GC_EMPTY){
-						j++;
-					}
-				}
-				j++;	// recent disc inserted
+		Player* player = nextPlayer() == playerOne ? playerOne : playerTwo;
+		Grid::Cell disc = player == playerOne ? Grid::GC_PLAYER_ONE : Grid::GC_PLAYER_TWO;
+		if(board->insertDisc(column, disc)){
 
-				if(checkForWinner(column, j, Grid::GC_PLAYER_ONE)){
-					playerOne->increaseScore();
-					board->fallDown();
-					// Goes through a nested loop to see if any more connect 4s been made at any row and column of the grid
-					for(int i = 0; i < board->rowCount(); i++){
-						for(int j = 0; j< board->columnCount(); j++){
-							if(board->cellAt(i, j) != Grid::GC_EMPTY){		// ignores the empty cells
-								Grid::Cell comboCell = board->cellAt(i, j);	// saves the cell
-								if(checkForWinner(j, i, board->cellAt(i, j))){	// if theres combo
+			// row (j) of the recent disc inserted, which sits on top of its column
+			int j = board->rowCount() - board->columnHeight(column);
 
-									if(comboCell == Grid::GC_PLAYER_ONE){		// if combocell was player one therefore there is player one combos
-										playerOneCombo = true;					// sets the bool playeronecombo as true
-									} else {
-										playerTwoCombo = true;					// vice versa for player two
-									}
-
-								}
-							}
-							// Check for every row and combo if it has gone through every row and combo
-							// which would make i as rowcount -1 and j as column cout - 1 on the last iteration
-							// Also need to check if there were any combo for player one OR player two
-							// If there were player one combos in the turn then increment score for player one
-							// make the bool playerone combo as false and fall down the cells
-							// reset i and j to see if any more combo have been made after falling down
-							// increment turn and vice versa for player 2
-							// Check if theres more moves which means there is a tie and game is complete
-							if(i == board->rowCount() - 1 && j == board->columnCount() - 1 && (playerOneCombo || playerTwoCombo)){
-								if(playerOneCombo){
-									playerOneCombo = false;
-									playerOne->increaseScore();
-								}
-								if(playerTwoCombo){
-									playerTwoCombo = false;
-									playerTwo->increaseScore();
-								}
-								board->fallDown();
-								i = 0; j = 0;
-							}
-						}
-					}
-				}
-				turn++;
-				if(board->noMoreMoves()){
-					gameStatus = GS_COMPLETE;
-					if(playerOne->getScore() > playerTwo->getScore()){
-						playerOne->increaseWins();
-					} else if(playerOne->getScore() < playerTwo->getScore()){
-						playerOne->increaseWins();
-					}
-				}
-				return true;
+			if(checkForWinner(column, j, disc)){
+				player->increaseScore();
+				resolveCascade();
 			}
-		} else {
-			if(board->insertDisc(column, Grid::GC_PLAYER_TWO )){
-				int j = -1;
-				for(unsigned int i = 0; i < board->rowCount(); i++){
-					if(board->cellAt(i, column) == Grid::GC_EMPTY){
-						j++;
-					}
+			turn++;
+			if(board->noMoreMoves()){
+				gameStatus = GS_COMPLETE;
+				if(playerOne->getScore() > playerTwo->getScore()){
+					playerOne->increaseWins();
+				} else if(playerOne->getScore() < playerTwo->getScore()){
+					playerTwo->increaseWins();
 				}
-				j++;	// recent disc inserted
-
-				if(checkForWinner(column, j, Grid::GC_PLAYER_TWO)){
-					playerTwo->increaseScore();
-					//playerTwoCombo = true;
-
-					board->fallDown();
-
-					for(int i = 0; i < board->rowCount(); i++){
-						for(int j = 0; j< board->columnCount(); j++){
-							Grid::Cell comboCell = board->cellAt(i, j);
-							if(board->cellAt(i, j) != Grid::GC_EMPTY){
-								if(checkForWinner(j, i, board->cellAt(i, j))){
+			}
+			return true;
+		}
+	}
+	// the game is not in progress or the column could not take another disc
+	return false;
+}
 
-									if(comboCell == Grid::GC_PLAYER_ONE){
-										playerOneCombo = true;
-									} else {
-										playerTwoCombo = true;
-									}
-								}
-							}
-							if(i == board->rowCount() - 1 && j == board->columnCount() - 1 && (playerOneCombo || playerTwoCombo)){
-								if(playerOneCombo){
-									playerOne->increaseScore();
-									playerOneCombo = false;
-								}
-								if(playerTwoCombo){
-									playerTwo->increaseScore();
-									playerTwoCombo = false;
-								}
-								board->fallDown();
-								i = 0; j = 0;
-							}
+void SuperGame::resolveCascade(){
+	// Before the move the grid held no combos, and the move's own combo has just been cleared, so any new combo has to
+	// include a disc that fell. Only the cells of combos through fallen discs are checked, in the same top-to-bottom,
+	// left-to-right order a scan of the whole grid would visit them: no other cell can be part of a combo, and checking
+	// a cell outside any combo changes nothing. Once a round clears something, each player with a combo in it scores a
+	// point and the discs fall again.
+	std::vector<std::pair<unsigned int, unsigned int> > moved;
+	std::vector<unsigned int> cells;
+	board->fallDown(moved);
+	bool firstRound = true;
+	while(!moved.empty()){
+		cells.clear();
+		for(unsigned int k = 0; k < moved.size(); k++){
+			collectComboCells(moved[k].first, moved[k].second, cells);
+		}
+		std::sort(cells.begin(), cells.end());
+		cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
 
-						}
-					}
-				}
-				turn++;
-				if(board->noMoreMoves()){
-					gameStatus = GS_COMPLETE;
-					if(playerOne->getScore() > playerTwo->getScore()){
-						playerOne->increaseWins();
-					} else if(playerOne->getScore() < playerTwo->getScore()){
-						playerTwo->increaseWins();
-					}
+		bool playerOneCombo = false;
+		bool playerTwoCombo = false;
+		for(unsigned int k = 0; k < cells.size(); k++){
+			if(cells[k] == 0 && !firstRound){
+				continue;	// rescans of the whole grid used to start one cell late, skipping the top left cell
+			}
+			int i = cells[k] / board->columnCount();
+			int j = cells[k] % board->columnCount();
+			Grid::Cell comboCell = board->cellAt(i, j);
+			if(comboCell != Grid::GC_EMPTY && checkForWinner(j, i, comboCell)){
+				if(comboCell == Grid::GC_PLAYER_ONE){
+					playerOneCombo = true;
+				} else {
+					playerTwoCombo = true;
 				}
-				return true;
 			}
 		}
-	} else	{
-		return false;
+		if(!playerOneCombo && !playerTwoCombo){
+			break;
+		}
+		if(playerOneCombo){
+			playerOne->increaseScore();
+		}
+		if(playerTwoCombo){
+			playerTwo->increaseScore();
+		}
+		moved.clear();
+		board->fallDown(moved);
+		firstRound = false;
 	}
+}
 
+void SuperGame::collectComboCells(unsigned int row, unsigned int column, std::vector<unsigned int>& cells) const{
+	// Keep each direction's line if it's at least the win length long
+	Grid::Cell disc = board->cellAt(row, column);
+	int x = column;
+	int y = row;
+	int columns = board->columnCount();
+	ComboSpan spans[4];
+	check_horizontal_combo(x, y, disc, spans[0]);
+	check_vertical_combo(x, y, disc, spans[1]);
+	check_diagonal_combo_NW_SE(x, y, disc, spans[2]);
+	check_diagonal_combo_SW_NE(x, y, disc, spans[3]);
+	for(unsigned int d = 0; d < 4; d++){
+		const ComboSpan& span = spans[d];
+		if(span.forward + span.backward + 1 >= (int)lineLength){
+			for(int k = -span.backward; k <= span.forward; k++){
+				cells.push_back((y + k * span.dy) * columns + x + k * span.dx);
+			}
+		}
+	}
 }
 
 bool SuperGame::checkForWinner(unsigned int column, int j, Grid::Cell disc){
 	// Check for combos in all directions
 	// make all the cell excluding the one we're checking as empty so we can check other directions with that cell as well
 	bool combo = false;
-	if (check_diagonal_combo_SW_NE(column,j,disc )) {
-		for(int i = 0; i < xIndex.size(); i++){
-			board->makeEmptyCell(xIndex[i],yIndex[i]);
-		}
+	ComboSpan span;
+	if (check_diagonal_combo_SW_NE(column,j,disc,span)) {
+		clearSpan(column, j, span);
 		combo = true;
 	}
-	if (check_diagonal_combo_NW_SE(column,j,disc )){
-		for(int i = 0; i < xIndex.size(); i++){
-			board->makeEmptyCell(xIndex[i],yIndex[i]);
-		}
+	if (check_diagonal_combo_NW_SE(column,j,disc,span)){
+		clearSpan(column, j, span);
 		combo = true;
 	}
 
-	if (check_vertical_combo(column,j,disc)){
-		for(int i = 0; i < xIndex.size(); i++){
-			board->makeEmptyCell(xIndex[i],yIndex[i]);
-		}
+	if (check_vertical_combo(column,j,disc,span)){
+		clearSpan(column, j, span);
 		combo = true;
 	}
-	if (check_horizontal_combo(column,j,disc )){
-		for(int i = 0; i < xIndex.size(); i++){
-			board->makeEmptyCell(xIndex[i],yIndex[i]);
-		}
+	if (check_horizontal_combo(column,j,disc,span)){
+		clearSpan(column, j, span);
 		combo = true;
 	}
 	// If there were combos then make the cell we were looking for combos as empty too
@@ -168,128 +132,84 @@ bool SuperGame::checkForWinner(unsigned int column, int j, Grid::Cell disc){
 	return combo;
 }
 
-bool SuperGame::check_diagonal_combo_SW_NE(int x, int y, Grid::Cell player){
-	yIndex.clear();
-	xIndex.clear();
-	int score = 1;
-	int count = 1;
-
-	while((y-count >= 0) && (x+count < board->columnCount() )){
-		if (board->cellAt(y-count , x+count) == player){	  //Check SW to NE
-			yIndex.push_back(y-count);
-			xIndex.push_back(x+count);
-			score++;
-			count++;
-		}
-		else break;  //If no combo is detected break from the loop
+void SuperGame::clearSpan(int x, int y, const ComboSpan& span){
+	for(int count = 1; count <= span.forward; count++){
+		board->makeEmptyCell(x + count * span.dx, y + count * span.dy);
 	}
-
-	count = 1;
-	while((y+count < board->rowCount() ) && (x-count >=0)){
-		if (board->cellAt(y+count, x-count) == player){	//Check NE to SW
-			yIndex.push_back(y+count);
-			xIndex.push_back(x-count);
-			score++;
-			count++;
-		}
-		else break;  //If no combo is detected break from the loop
+	for(int count = 1; count <= span.backward; count++){
+		board->makeEmptyCell(x - count * span.dx, y - count * span.dy);
 	}
-
-	if (score >= 4) return true;
-	else return false;
 }
 
-bool SuperGame::check_diagonal_combo_NW_SE(int x, int y, Grid::Cell player){
-	yIndex.clear();
-	xIndex.clear();
-	int score = 1;
-	int count = 1;
-
-	while((y+count < board->rowCount() ) && (x+count < board->columnCount() )){
-		if (board->cellAt(y+count, x+count) == player){	 //Check NW to SE
-			yIndex.push_back(y+count);
-			xIndex.push_back(x+count);
-			score++;
-			count++;
+bool SuperGame::measureCombo(int x, int y, Grid::Cell player, int dx, int dy, ComboSpan& span) const{
+	// Count the player's discs stepping away from the cell each way, stopping at the first other cell or the edge
+	int rows = board->rowCount();
+	int columns = board->columnCount();
+	span.dx = dx;
+	span.dy = dy;
+	span.forward = 0;
+	span.backward = 0;
+	for(int count = 1; ; count++){
+		int cx = x + count * dx;
+		int cy = y + count * dy;
+		if(cx < 0 || cx >= columns || cy < 0 || cy >= rows || board->cellAt(cy, cx) != player){
+			break;
 		}
-		else break;  //If no combo is detected break from the loop
+		span.forward++;
 	}
-
-	count = 1;
-	while((y-count >=0 ) && (x-count >=0)){
-		if (board->cellAt(y-count, x-count) == player){	  //Check SE to NW
-			yIndex.push_back(y-count);
-			xIndex.push_back(x-count);
-			score++;
-			count++;
+	for(int count = 1; ; count++){
+		int cx = x - count * dx;
+		int cy = y - count * dy;
+		if(cx < 0 || cx >= columns || cy < 0 || cy >= rows || board->cellAt(cy, cx) != player){
+			break;
 		}
-		else break;  //If no combo is detected break from the loop
+		span.backward++;
 	}
+	return span.forward + span.backward + 1 >= (int)lineLength;	// if score is atleast the win length then there is a combo
+}
 
-	if (score >= 4) return true;
-	else return false;
+bool SuperGame::check_diagonal_combo_SW_NE(int x, int y, Grid::Cell player, ComboSpan& span) const{
+	return measureCombo(x, y, player, 1, -1, span);		// SW to NE
 }
 
-bool SuperGame::check_vertical_combo(int x, int y, Grid::Cell player){
-	yIndex.clear();
-	xIndex.clear();
-	int score = 1;
-	int count = 1;
+bool SuperGame::check_diagonal_combo_NW_SE(int x, int y, Grid::Cell player, ComboSpan& span) const{
+	return measureCombo(x, y, player, 1, 1, span);		// NW to SE
+}
 
-	while(y+count < board->rowCount() ){				// Going south
-		if (board->cellAt(y+count, x) == player){
-			yIndex.push_back(y+count);
-			xIndex.push_back(x);
-			score++;
-			count++;
-		}
-		else break;  //If no combo is detected break from the loop
-	}
-	count = 1;
+bool SuperGame::check_vertical_combo(int x, int y, Grid::Cell player, ComboSpan& span) const{
+	return measureCombo(x, y, player, 0, 1, span);		// going south
+}
 
-	while(y-count >= 0 ){							// going north
-		if (board->cellAt(y-count, x) == player){
-			yIndex.push_back(y-count);
-			xIndex.push_back(x);
-			score++;
-			count++;
-		}
-		else break;  //If no combo is detected break from the loop
-	}
+bool SuperGame::check_horizontal_combo(int x, int y, Grid::Cell player, ComboSpan& span) const{
+	return measureCombo(x, y, player, 1, 0, span);
+}
 
-	if (score >= 4) return true;
-	else return false;
+bool SuperGame::check_diagonal_combo_SW_NE(int x, int y, Grid::Cell player) const{
+	ComboSpan span;
+	return check_diagonal_combo_SW_NE(x, y, player, span);
 }
 
-bool SuperGame::check_horizontal_combo(int x, int y, Grid::Cell player){
-	yIndex.clear();
-	xIndex.clear();
-	int score = 1;
-	int count = 1;
+bool SuperGame::check_diagonal_combo_NW_SE(int x, int y, Grid::Cell player) const{
+	ComboSpan span;
+	return check_diagonal_combo_NW_SE(x, y, player, span);
+}
 
-	while(x+count < board->columnCount() ){
-		if (board->cellAt(y, x+count) == player){
-			yIndex.push_back(y);
-			xIndex.push_back(x+count);
-			score++;
-			count++;
-		}
-		else break;  //If no combo is detected break from the loop
-	}
+bool SuperGame::check_vertical_combo(int x, int y, Grid::Cell player) const{
+	ComboSpan span;
+	return check_vertical_combo(x, y, player, span);
+}
 
-	count = 1;
-	while(x-count >=0){
-		if (board->cellAt(y, x-count) == player){
-			yIndex.push_back(y);
-			xIndex.push_back(x-count);
-			score++;
-			count++;
-		}
-		else break;  //If no combo is detected break from the loop
-	}
+bool SuperGame::check_horizontal_combo(int x, int y, Grid::Cell player) const{
+	ComboSpan span;
+	return check_horizontal_combo(x, y, player, span);
+}
+
+bool SuperGame::supportsUndo() const{
+	return false;
+}
 
-	if (score >= 4) return true;
-	else return false;
+Game* SuperGame::clone() const{
+	return new SuperGame(*this);
 }
 
 const Player* SuperGame::winner() const{
@@ -5,35 +5,67 @@
 
 class SuperGame : public Game {
 public:
-	// Plays next turn on a column
+	// Plays next turn on a column. The discs a move clears can't be put back cheaply, so SuperGame moves are not kept on
+	// the move stack and undoMove always returns false
 	bool playNextTurn(unsigned int column);
 
+	// Returns false, see above
+	virtual bool supportsUndo() const;
+
+	// The line of a player's discs running through a cell in one direction: `forward` discs stepping (dx, dy) away from
+	// the cell and `backward` discs stepping the other way, not counting the cell itself
+	struct ComboSpan {
+		int dx;
+		int dy;
+		int forward;
+		int backward;
+	};
+
 	// Inherited from Game class and modified. *Doesn't check for winner*
 	// checks for combo and disappears it
 	bool checkForWinner(unsigned int column, int j, Grid::Cell disc);
 
-	// checks horizontal combo around a particular cell and stores it in vector
-	bool check_horizontal_combo(int x, int y, Grid::Cell player);
+	// checks horizontal combo around a particular cell
+	bool check_horizontal_combo(int x, int y, Grid::Cell player) const;
+
+	// checks vertical combo around a particular cell
+
+	bool check_vertical_combo(int x, int y, Grid::Cell player) const;
 
-	// checks vertical combo around a particular cell and stores it in vector
+	// checks diagonal combo (\) around a particular cell
 
-	bool check_vertical_combo(int x, int y, Grid::Cell player);
+	bool check_diagonal_combo_NW_SE(int x, int y, Grid::Cell player) const;
 
-	// checks diagonal combo (\) around a particular cell and stores it in vector
+	// checks diagonal combo (/) around a particular cell
 
-	bool check_diagonal_combo_NW_SE(int x, int y, Grid::Cell player);
+	bool check_diagonal_combo_SW_NE(int x, int y, Grid::Cell player) const;
 
-	// checks diagonal combo (/) around a particular cell and stores it in vector
+	// Same as above, also filling in the span of the line found, whether or not it's long enough to be a combo
+	bool check_horizontal_combo(int x, int y, Grid::Cell player, ComboSpan& span) const;
+	bool check_vertical_combo(int x, int y, Grid::Cell player, ComboSpan& span) const;
+	bool check_diagonal_combo_NW_SE(int x, int y, Grid::Cell player, ComboSpan& span) const;
+	bool check_diagonal_combo_SW_NE(int x, int y, Grid::Cell player, ComboSpan& span) const;
 
-	bool check_diagonal_combo_SW_NE(int x, int y, Grid::Cell player);
+	// Returns a heap-allocated copy of this SuperGame, see Game::clone
+	virtual Game* clone() const;
 
 	// Returns the winner
 
 	virtual const Player* winner() const;
 
 private:
-	std::vector <int>  xIndex;
-	std::vector <int>  yIndex;
+	// Clears the combos left behind once the discs above a cleared combo fall, round after round, until none are left
+	void resolveCascade();
+
+	// Adds every cell of the lines of winLength() or more through the (non-empty) cell to `cells`, as
+	// row * columns + column
+	void collectComboCells(unsigned int row, unsigned int column, std::vector<unsigned int>& cells) const;
+
+	// Measures the line of the player's discs through (x, y) in direction (dx, dy), returning true if it's a combo
+	bool measureCombo(int x, int y, Grid::Cell player, int dx, int dy, ComboSpan& span) const;
+
+	// Empties every cell of the span around (x, y), leaving (x, y) itself
+	void clearSpan(int x, int y, const ComboSpan& span);
 };
 
 #endif /* end of include guard: SUPERGAME_HPP */
@@ -0,0 +1,66 @@
+#include "TimeManager.hpp"
+
+TimeManager::TimeManager(){
+	moveTime = 0;
+	remaining = 0;
+	increment = 0;
+	movesToGo = 0;
+	soft = 0;
+	hard = 0;
+	limited = false;
+	startTime = std::chrono::steady_clock::now();
+	softDeadline = startTime;
+	hardDeadline = startTime;
+}
+
+void TimeManager::setMoveTime(unsigned int milliseconds){
+	moveTime = milliseconds;
+	remaining = 0;
+	increment = 0;
+	movesToGo = 0;
+}
+
+void TimeManager::setClock(unsigned int remaining, unsigned int increment, unsigned int movesToGo){
+	moveTime = 0;
+	// A clock with nothing left still gets a millisecond, so it isn't mistaken for no limit at all
+	this->remaining = remaining == 0 ? 1 : remaining;
+	this->increment = increment;
+	this->movesToGo = movesToGo;
+}
+
+void TimeManager::start(unsigned int movesLeft){
+	startTime = std::chrono::steady_clock::now();
+	limited = moveTime != 0 || remaining != 0;
+	if(moveTime != 0){
+		hard = moveTime;
+		soft = moveTime / 2;
+	} else if(remaining != 0){
+		unsigned int moves = movesToGo != 0 ? movesToGo : MAX_MOVES_TO_GO;
+		if(movesLeft != 0 && movesLeft < moves){
+			moves = movesLeft;
+		}
+		unsigned long long share = remaining / moves + (unsigned long long)increment * 3 / 4;
+		unsigned long long cap = remaining / 2;
+		soft = (unsigned int)(share < cap ? share : cap);
+		hard = (unsigned int)(3 * share < cap ? 3 * share : cap);
+		hard = hard == 0 ? 1 : hard;
+	} else {
+		soft = 0;
+		hard = 0;
+	}
+	softDeadline = startTime + std::chrono::milliseconds(soft);
+	hardDeadline = startTime + std::chrono::milliseconds(hard);
+}
+
+bool TimeManager::pastSoftLimit() const{
+	return limited && std::chrono::steady_clock::now() >= softDeadline;
+}
+
+bool TimeManager::pastHardLimit() const{
+	return limited && std::chrono::steady_clock::now() >= hardDeadline;
+}
+
+unsigned int TimeManager::elapsed() const{
+	std::chrono::steady_clock::duration time = std::chrono::steady_clock::now() - startTime;
+	return std::chrono::duration_cast<std::chrono::milliseconds>(time).count();
+}
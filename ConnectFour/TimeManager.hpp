@@ -0,0 +1,85 @@
+#ifndef TIMEMANAGER_HPP
+#define TIMEMANAGER_HPP
+
+#include <chrono>
+
+/*
+A TimeManager decides how long a search may think about each move, and tells it when to stop. It either gives every
+move the same budget (`setMoveTime`) or shares out what is left on a game clock (`setClock`).
+
+Each move gets two limits, worked out by `start`. Past the soft limit a search should not begin anything new, such as
+another iteration of iterative deepening, which usually takes several times as long as the one before it. At the hard
+limit a search must stop whatever it is doing and answer with what it has. With a move time the hard limit is the move
+time and the soft limit half of it. With a clock the soft limit is the move's share of the clock, the remaining time
+split evenly over the moves still to play plus three quarters of the increment, and the hard limit is three times that,
+but never more than half of the remaining time.
+
+The limits are kept as points in time, so checking them costs a single read of the clock.
+*/
+class TimeManager {
+public:
+    /*
+    Create a TimeManager without any limit.
+    */
+    TimeManager();
+
+    /*
+    Give every move (roughly) the given number of milliseconds, or remove the limit with 0. Replaces any clock.
+    */
+    void setMoveTime(unsigned int milliseconds);
+
+    /*
+    Share out a game clock with `remaining` milliseconds left, `increment` milliseconds added after every move, and
+    `movesToGo` moves to play before the clock is next topped up (0 if it never is, in which case `start` estimates how
+    many moves are left). Replaces any move time.
+    */
+    void setClock(unsigned int remaining, unsigned int increment = 0, unsigned int movesToGo = 0);
+
+    /*
+    Start timing a move, working out its limits. `movesLeft` is the most moves the player to move can still make in the
+    game, which caps the number of moves the clock is shared between.
+    */
+    void start(unsigned int movesLeft);
+
+    /*
+    Return `true` if the move has gone past its soft limit.
+    */
+    bool pastSoftLimit() const;
+
+    /*
+    Return `true` if the move has reached its hard limit.
+    */
+    bool pastHardLimit() const;
+
+    /*
+    Return the soft limit of the move being timed in milliseconds, or 0 if there is none.
+    */
+    unsigned int softLimit() const { return soft; }
+
+    /*
+    Return the hard limit of the move being timed in milliseconds, or 0 if there is none.
+    */
+    unsigned int hardLimit() const { return hard; }
+
+    /*
+    Return the number of milliseconds since `start`.
+    */
+    unsigned int elapsed() const;
+
+private:
+    // Most moves a clock without a number of moves to go is shared between
+    static const unsigned int MAX_MOVES_TO_GO = 30;
+
+    unsigned int moveTime;
+    unsigned int remaining;
+    unsigned int increment;
+    unsigned int movesToGo;
+    unsigned int soft;
+    unsigned int hard;
+    bool limited;       // whether the move being timed has limits
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point softDeadline;
+    std::chrono::steady_clock::time_point hardDeadline;
+};
+
+#endif /* end of include guard: TIMEMANAGER_HPP */
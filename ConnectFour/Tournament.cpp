@@ -0,0 +1,190 @@
+#include "Tournament.hpp"
+#include "Policy.hpp"
+#include "SuperGame.hpp"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Number of games handed out at a time; small enough to balance the load, big enough to keep the queues quiet
+static const unsigned long long CHUNK_SIZE = 16;
+
+struct Tournament::Queue {
+	std::mutex lock;
+	std::deque<unsigned long long> chunks;	// first game number of each chunk
+};
+
+Tournament::Tournament(const std::string& policyA, const std::string& policyB){
+	policyNames[0] = policyA;
+	policyNames[1] = policyB;
+	games = 1000;
+	threads = 0;
+	rows = 6;
+	columns = 7;
+	mode = TM_GAME;
+	winLength = 4;
+	seed = 0;
+	book = 0;
+}
+
+void Tournament::setGames(unsigned long long count){
+	games = count;
+}
+
+void Tournament::setThreads(unsigned int count){
+	threads = count;
+}
+
+void Tournament::setGridSize(unsigned int rows, unsigned int columns){
+	this->rows = rows;
+	this->columns = columns;
+}
+
+void Tournament::setMode(Mode mode){
+	this->mode = mode;
+}
+
+void Tournament::setWinLength(unsigned int length){
+	winLength = length;
+}
+
+void Tournament::setSeed(unsigned long long value){
+	seed = value;
+}
+
+void Tournament::setBook(const OpeningBook* book){
+	this->book = book;
+}
+
+void Tournament::work(Queue* queues, unsigned int index, Result& finished) const{
+	std::unique_ptr<Policy> policies[2];
+	for(unsigned int i = 0; i < 2; i++){
+		policies[i].reset(Policy::create(policyNames[i]));
+		policies[i]->setBook(book);
+	}
+	Player playerA(policyNames[0] + " (A)");
+	Player playerB(policyNames[1] + " (B)");
+	Player* players[2] = { &playerA, &playerB };
+
+	// One game for each policy moving first, reused (restarted) for every game of that kind
+	std::unique_ptr<Game> matches[2];
+	for(unsigned int i = 0; i < 2; i++){
+		matches[i].reset(mode == TM_SUPERGAME ? new SuperGame() : new Game());
+		matches[i]->setGrid(new Grid(rows, columns));
+		matches[i]->setWinLength(winLength);
+		matches[i]->setPlayerOne(players[i]);
+		matches[i]->setPlayerTwo(players[1 - i]);
+	}
+
+	// The tallies are kept on this thread's stack and only written out once, when the worker is done, so workers never
+	// write to cache lines next to each other's while they play
+	Result result = finished;
+	unsigned int count = result.threads;
+	while(true){
+		// Take the newest chunk of our own, otherwise the oldest chunk of somebody else's
+		bool found = false;
+		unsigned long long first = 0;
+		for(unsigned int k = 0; k < count && !found; k++){
+			Queue& queue = queues[(index + k) % count];
+			std::lock_guard<std::mutex> guard(queue.lock);
+			if(!queue.chunks.empty()){
+				if(k == 0){
+					first = queue.chunks.back();
+					queue.chunks.pop_back();
+				} else {
+					first = queue.chunks.front();
+					queue.chunks.pop_front();
+					result.steals++;
+				}
+				found = true;
+			}
+		}
+		if(!found){
+			// chunks are never added once the workers start, so everything is taken
+			break;
+		}
+
+		unsigned long long last = std::min(first + CHUNK_SIZE, games);
+		for(unsigned long long number = first; number < last; number++){
+			unsigned int starter = number % 2;	// policy moving first
+			Game& game = *matches[starter];
+			game.restart();
+			policies[0]->seed(seed * 0x9E3779B97F4A7C15ULL + 2 * number);
+			policies[1]->seed(seed * 0x9E3779B97F4A7C15ULL + 2 * number + 1);
+			while(game.status() == Game::GS_IN_PROGRESS){
+				unsigned int side = game.nextPlayer() == players[0] ? 0 : 1;
+				Grid::Cell disc = side == starter ? Grid::GC_PLAYER_ONE : Grid::GC_PLAYER_TWO;
+				if(!game.playNextTurn(policies[side]->chooseColumn(game, disc))){
+					break;	// policies only choose playable columns, so this never happens
+				}
+				result.moves++;
+			}
+
+			const Player* winner = game.winner();
+			for(unsigned int side = 0; side < 2; side++){
+				Tally& tally = result.tallies[side];
+				if(winner == 0){
+					tally.draws++;
+				} else if(winner == players[side]){
+					tally.wins++;
+				} else {
+					tally.losses++;
+				}
+				tally.score += players[side]->getScore();
+			}
+			result.games++;
+		}
+	}
+	finished = result;
+}
+
+Tournament::Result Tournament::run() const{
+	Result total = Result();
+	total.threads = threads == 0 ? std::thread::hardware_concurrency() : threads;
+	if(total.threads == 0){
+		total.threads = 1;
+	}
+	for(unsigned int i = 0; i < 2; i++){
+		std::unique_ptr<Policy> policy(Policy::create(policyNames[i]));
+		if(!policy){
+			return total;
+		}
+	}
+
+	// Deal the chunks out evenly, in order, so each worker starts on a contiguous run of games
+	std::unique_ptr<Queue[]> queues(new Queue[total.threads]);
+	unsigned long long chunks = (games + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	for(unsigned long long i = 0; i < chunks; i++){
+		queues[i * total.threads / chunks].chunks.push_back(i * CHUNK_SIZE);
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<Result> results(total.threads, total);
+	std::vector<std::thread> workers;
+	for(unsigned int i = 1; i < total.threads; i++){
+		workers.push_back(std::thread(&Tournament::work, this, queues.get(), i, std::ref(results[i])));
+	}
+	work(queues.get(), 0, results[0]);
+	for(unsigned int i = 0; i < workers.size(); i++){
+		workers[i].join();
+	}
+	std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+	total.seconds = std::chrono::duration<double>(elapsed).count();
+
+	// Only now, with every worker finished, are the separate tallies added together
+	for(unsigned int i = 0; i < total.threads; i++){
+		for(unsigned int side = 0; side < 2; side++){
+			total.tallies[side].wins += results[i].tallies[side].wins;
+			total.tallies[side].losses += results[i].tallies[side].losses;
+			total.tallies[side].draws += results[i].tallies[side].draws;
+			total.tallies[side].score += results[i].tallies[side].score;
+		}
+		total.games += results[i].games;
+		total.moves += results[i].moves;
+		total.steals += results[i].steals;
+	}
+	return total;
+}
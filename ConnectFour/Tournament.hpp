@@ -0,0 +1,115 @@
+#ifndef TOURNAMENT_HPP
+#define TOURNAMENT_HPP
+
+#include <string>
+
+class OpeningBook;
+
+/*
+A Tournament plays many independent games between two policies (see Policy) without any human input, and tallies the
+results for each policy. The policies take turns to move first, policy A moving first in the even numbered games.
+
+Games are split into small chunks that are shared out between a pool of worker threads. Each worker starts with an equal
+share of the chunks and plays them from the back of its own queue; once its queue is empty it steals chunks from the
+front of the other workers' queues, so a worker that drew long games doesn't hold up the rest. Every worker keeps its
+own players, games, policies and tallies, and the tallies are only added together once all the workers have finished.
+
+The policies of every game are seeded from the tournament seed and the game number, so the same tournament gives the
+same tallies however many threads it is played on.
+*/
+class Tournament {
+public:
+    /*
+    The Mode enum selects the rules played: a standard Game (TM_GAME) or a SuperGame (TM_SUPERGAME).
+    */
+    enum Mode { TM_GAME, TM_SUPERGAME };
+
+    /*
+    The results of one policy over a whole tournament.
+    */
+    struct Tally {
+        unsigned long long wins;
+        unsigned long long losses;
+        unsigned long long draws;
+        unsigned long long score;   // sum of the player's score at the end of every game
+    };
+
+    /*
+    The results of a tournament.
+    */
+    struct Result {
+        Tally tallies[2];           // for policy A and policy B
+        unsigned long long games;   // number of games played, 0 if a policy name wasn't recognised
+        unsigned long long moves;   // number of discs played over every game
+        unsigned long long steals;  // number of chunks of games taken from another worker's queue
+        unsigned int threads;       // number of worker threads used
+        double seconds;             // wall clock time taken
+    };
+
+    /*
+    Create a tournament between the two named policies (see `Policy::create`). By default it plays 1000 standard games
+    on a 6x7 grid, using one thread per core.
+    */
+    Tournament(const std::string& policyA, const std::string& policyB);
+
+    /*
+    Set the number of games to play.
+    */
+    void setGames(unsigned long long count);
+
+    /*
+    Set the number of worker threads. A count of 0 uses one thread per core.
+    */
+    void setThreads(unsigned int count);
+
+    /*
+    Set the size of the grid every game is played on.
+    */
+    void setGridSize(unsigned int rows, unsigned int columns);
+
+    /*
+    Set the rules to play by.
+    */
+    void setMode(Mode mode);
+
+    /*
+    Set the number of discs in a row needed to win (see `Game::setWinLength`).
+    */
+    void setWinLength(unsigned int length);
+
+    /*
+    Set the seed the policies' random choices are drawn from.
+    */
+    void setSeed(unsigned long long value);
+
+    /*
+    Give every policy the opening book to consult (see `Policy::setBook`), or none if `book` is null (0). The book must
+    stay open until the tournament has been run.
+    */
+    void setBook(const OpeningBook* book);
+
+    /*
+    Play every game of the tournament and return the combined results.
+    */
+    Result run() const;
+
+private:
+    // Queue of chunks of game numbers belonging to a single worker
+    struct Queue;
+
+    // Play chunks of games from the queues until every queue is empty, starting from queue `index`, and store what was
+    // played in `finished`
+    void work(Queue* queues, unsigned int index, Result& finished) const;
+
+    std::string policyNames[2];
+    unsigned long long games;
+    unsigned int threads;
+    unsigned int rows;
+    unsigned int columns;
+    Mode mode;
+    unsigned int winLength;
+    unsigned long long seed;
+    const OpeningBook* book;
+};
+
+#endif /* end of include guard: TOURNAMENT_HPP */
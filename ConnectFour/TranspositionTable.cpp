@@ -0,0 +1,116 @@
+#include "TranspositionTable.hpp"
+
+TranspositionTable::TranspositionTable(unsigned int megabytes){
+	replacement = TR_DEPTH_PREFERRED;
+	buckets = 0;
+	bucketMask = 0;
+	resize(megabytes);
+}
+
+void TranspositionTable::resize(unsigned int megabytes){
+	// Largest power of two number of buckets that fits in the budget
+	size_t count = ((size_t)megabytes << 20) / sizeof(Bucket);
+	size_t size = 1;
+	while(size * 2 <= count){
+		size *= 2;
+	}
+	if(count == 0){
+		storage.reset();
+		buckets = 0;
+		bucketMask = 0;
+		return;
+	}
+	storage.reset(new Bucket[size + 1]);
+	// Start the table on the first cache line boundary inside the storage
+	uintptr_t address = (uintptr_t)storage.get();
+	buckets = (Bucket*)((address + sizeof(Bucket) - 1) & ~(uintptr_t)(sizeof(Bucket) - 1));
+	bucketMask = size - 1;
+	clear();
+}
+
+void TranspositionTable::clear(){
+	for(size_t i = 0; buckets != 0 && i <= bucketMask; i++){
+		for(unsigned int j = 0; j < 4; j++){
+			buckets[i].slots[j].check.store(0, std::memory_order_relaxed);
+			buckets[i].slots[j].data.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+void TranspositionTable::setReplacement(Replacement policy){
+	replacement = policy;
+}
+
+size_t TranspositionTable::capacity() const{
+	return buckets == 0 ? 0 : (bucketMask + 1) * 4;
+}
+
+TranspositionTable::Bucket& TranspositionTable::bucketFor(uint64_t key) const{
+	// Position keys are far from random, so mix all of their bits into the index
+	uint64_t hash = key * 0x9E3779B97F4A7C15ULL;
+	return buckets[(hash >> 32) & bucketMask];
+}
+
+uint64_t TranspositionTable::pack(int score, Bound bound, unsigned int depth, unsigned int move){
+	// bound is never TB_NONE here, so a stored entry never packs to 0
+	return (uint64_t)(unsigned char)score | (uint64_t)(unsigned char)bound << 8 | (uint64_t)(unsigned char)depth << 16
+		   | (uint64_t)(unsigned char)move << 24;
+}
+
+void TranspositionTable::unpack(uint64_t data, Entry& entry){
+	entry.score = (signed char)(data & 0xFF);
+	entry.bound = (data >> 8) & 0xFF;
+	entry.depth = (data >> 16) & 0xFF;
+	entry.move = (data >> 24) & 0xFF;
+}
+
+bool TranspositionTable::probe(uint64_t key, Entry& entry) const{
+	if(buckets == 0){
+		return false;
+	}
+	const Bucket& bucket = bucketFor(key);
+	for(unsigned int i = 0; i < 4; i++){
+		uint64_t data = bucket.slots[i].data.load(std::memory_order_relaxed);
+		uint64_t check = bucket.slots[i].check.load(std::memory_order_relaxed);
+		if(data != 0 && (check ^ data) == key){
+			entry.key = key;
+			unpack(data, entry);
+			return true;
+		}
+	}
+	return false;
+}
+
+void TranspositionTable::store(uint64_t key, int score, Bound bound, unsigned int depth, unsigned int move){
+	if(buckets == 0){
+		return;
+	}
+	Bucket& bucket = bucketFor(key);
+	// Reuse the slot already holding this key, or an empty one, if there is one
+	Slot* slot = 0;
+	for(unsigned int i = 0; i < 4 && slot == 0; i++){
+		uint64_t data = bucket.slots[i].data.load(std::memory_order_relaxed);
+		if(data == 0 || (bucket.slots[i].check.load(std::memory_order_relaxed) ^ data) == key){
+			slot = &bucket.slots[i];
+		}
+	}
+	if(slot == 0){
+		if(replacement == TR_ALWAYS){
+			slot = &bucket.slots[(key * 0x9E3779B97F4A7C15ULL) >> 62];
+		} else {
+			// Evict the entry that was cheapest to compute
+			Entry entry;
+			unsigned int lowest = 256;
+			for(unsigned int i = 0; i < 4; i++){
+				unpack(bucket.slots[i].data.load(std::memory_order_relaxed), entry);
+				if(entry.depth < lowest){
+					lowest = entry.depth;
+					slot = &bucket.slots[i];
+				}
+			}
+		}
+	}
+	uint64_t data = pack(score, bound, depth, move);
+	slot->data.store(data, std::memory_order_relaxed);
+	slot->check.store(key ^ data, std::memory_order_relaxed);
+}
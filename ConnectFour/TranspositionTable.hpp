@@ -0,0 +1,123 @@
+#ifndef TRANSPOSITIONTABLE_HPP
+#define TRANSPOSITIONTABLE_HPP
+
+#include <stdint.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/*
+The TranspositionTable remembers the results of positions already searched, so a search that reaches the same position
+through a different order of moves can reuse the earlier result instead of searching it again.
+
+Positions are identified by a 64-bit key (see `Position::key`), which is unique among positions of the same size, so a
+matching key always means a matching position. Entries are grouped into buckets of four that fill exactly one 64-byte
+cache line, and a key can only be stored in the bucket its hash selects, so a lookup touches a single cache line.
+
+When a bucket is full, a new entry replaces one of the existing entries according to the replacement policy.
+
+The table can be shared by several threads searching at once without any locking. Each slot holds two 64-bit words, the
+packed result and the key XORed with that result, and both are read and written atomically. If two threads write the
+same slot at the same time a reader may see one word from each write, but the key check then fails and the slot is
+treated as a miss, so a torn entry is never mistaken for a result. Resizing and clearing the table must not overlap a
+search.
+*/
+class TranspositionTable {
+public:
+    /*
+    The Bound enum describes how a stored score relates to the true value of the position. TB_EXACT scores are the true
+    value, TB_LOWER scores are a lower bound on it (the search failed high) and TB_UPPER scores are an upper bound on it
+    (the search failed low).
+    */
+    enum Bound { TB_NONE, TB_EXACT, TB_LOWER, TB_UPPER };
+
+    /*
+    The Replacement enum selects which entry of a full bucket is overwritten by a new entry. TR_DEPTH_PREFERRED replaces
+    the entry with the smallest depth (the one that was cheapest to compute), while TR_ALWAYS overwrites a slot picked
+    from the new key whatever it holds.
+    */
+    enum Replacement { TR_DEPTH_PREFERRED, TR_ALWAYS };
+
+    /*
+    A single stored result, as returned by `probe`.
+    */
+    struct Entry {
+        uint64_t key;
+        signed char score;
+        unsigned char bound;    // a Bound value
+        unsigned char depth;    // size of the search that produced the entry, bigger is more valuable
+        unsigned char move;     // best column found, or NO_MOVE
+    };
+
+    /*
+    Value of Entry::move when no best move is known.
+    */
+    static const unsigned char NO_MOVE = 255;
+
+    /*
+    Create a table using at most the given number of megabytes. The number of buckets is rounded down to a power of two.
+    A size of 0 creates a table that never stores anything.
+    */
+    TranspositionTable(unsigned int megabytes = 16);
+
+    /*
+    Change the memory budget of the table, discarding all stored entries.
+    */
+    void resize(unsigned int megabytes);
+
+    /*
+    Discard all stored entries.
+    */
+    void clear();
+
+    /*
+    Set the replacement policy used when storing into a full bucket.
+    */
+    void setReplacement(Replacement policy);
+
+    /*
+    Look up the entry for the given key. Returns `true` and fills in `entry` if the key was found.
+    */
+    bool probe(uint64_t key, Entry& entry) const;
+
+    /*
+    Store a result for the given key, replacing any earlier entry for the same key.
+    */
+    void store(uint64_t key, int score, Bound bound, unsigned int depth, unsigned int move);
+
+    /*
+    Return the number of entries the table can hold.
+    */
+    size_t capacity() const;
+
+private:
+    /*
+    Private copy constructor and assignment operator - tables are large and point into their own storage, so they
+    cannot be copied.
+    */
+    TranspositionTable(const TranspositionTable&);
+    TranspositionTable& operator=(const TranspositionTable&);
+
+    struct Slot {
+        std::atomic<uint64_t> check;    // key XORed with data, so a slot torn by two writers fails the key check
+        std::atomic<uint64_t> data;     // score, bound, depth and move packed together, 0 for an empty slot
+    };
+
+    struct Bucket {
+        Slot slots[4];
+    };
+
+    // Bucket a key belongs to
+    Bucket& bucketFor(uint64_t key) const;
+
+    // Pack a result into a single word, and unpack it again
+    static uint64_t pack(int score, Bound bound, unsigned int depth, unsigned int move);
+    static void unpack(uint64_t data, Entry& entry);
+
+    std::unique_ptr<Bucket[]> storage;  // over-allocated by one bucket so the table can start on a cache line boundary
+    Bucket* buckets;
+    size_t bucketMask;
+    Replacement replacement;
+};
+
+#endif /* end of include guard: TRANSPOSITIONTABLE_HPP */
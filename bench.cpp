@@ -0,0 +1,454 @@
+// Microbenchmarks for the hot paths of Grid, Game and SuperGame, on grids from 4x4 up to 1000x1000, for the Playout
+// kernel on the grids that fit a Position, and for EndgameDatabase probes on grids of up to 20 cells.
+//
+// Each benchmark is first calibrated so one repetition takes about the target time, and run once untimed to warm up.
+// It is then timed over a number of repetitions, and the median, 10th and 90th percentile of the time per operation are
+// printed for each benchmark and grid size, along with the number of operations in each repetition. Compare medians
+// between builds; a wide spread between the percentiles means the machine was busy.
+//
+// usage: c4_bench [-s sizes] [-f filter] [-n repetitions] [-t ms per repetition]
+//
+// Sizes are given as a comma separated list of rows x columns (e.g. "6x7,100x100"). Only the benchmarks whose names
+// contain the filter are run.
+#include "ConnectFour/EndgameDatabase.hpp"
+#include "ConnectFour/Game.hpp"
+#include "ConnectFour/GameBatch.hpp"
+#include "ConnectFour/Playout.hpp"
+#include "ConnectFour/SuperGame.hpp"
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Everything a benchmark works on, set up once for each grid size
+struct State {
+	unsigned int rows;
+	unsigned int columns;
+	unique_ptr<Grid> grid;
+	unique_ptr<Game> game;
+	Player one;
+	Player two;
+	Playout playout;
+	unique_ptr<GameBatch> batch;
+	vector<unsigned char> choices;		// a column for every game of the batch
+	unique_ptr<EndgameDatabase> endgames;
+	vector<Position> positions;			// positions to probe, picked at random
+	vector<unsigned int> cellRows;		// cells to visit, picked at random
+	vector<unsigned int> cellColumns;
+	uint64_t random;
+	unsigned long long sink;			// results are added up here so the work can't be optimised away
+
+	State() : one("One"), two("Two") {}
+};
+
+// xorshift64, good enough to scatter the cells and columns visited
+unsigned int nextRandom(State& state, unsigned int bound){
+	state.random ^= state.random << 13;
+	state.random ^= state.random >> 7;
+	state.random ^= state.random << 17;
+	return (unsigned int)((state.random >> 32) % bound);
+}
+
+// Fill about `fraction` of the grid with discs of both players, dropped into random columns
+void fillGrid(State& state, Grid& grid, double fraction){
+	unsigned int discs = (unsigned int)(grid.rowCount() * grid.columnCount() * fraction);
+	for(unsigned int i = 0; i < discs; i++){
+		unsigned int column = nextRandom(state, grid.columnCount());
+		while(grid.isColumnFull(column)){
+			column = (column + 1) % grid.columnCount();
+		}
+		grid.insertDisc(column, nextRandom(state, 2) == 0 ? Grid::GC_PLAYER_ONE : Grid::GC_PLAYER_TWO);
+	}
+}
+
+// A grid half filled at random, and a list of its cells to visit that hold a disc
+void setupHalfFull(State& state){
+	state.grid.reset(new Grid(state.rows, state.columns));
+	fillGrid(state, *state.grid, 0.5);
+	state.cellRows.clear();
+	state.cellColumns.clear();
+	while(state.cellRows.size() < 4096){
+		unsigned int row = nextRandom(state, state.rows);
+		unsigned int column = nextRandom(state, state.columns);
+		if(state.grid->cellAt(row, column) != Grid::GC_EMPTY){
+			state.cellRows.push_back(row);
+			state.cellColumns.push_back(column);
+		}
+	}
+}
+
+// A nearly full grid, for knocking holes into
+void setupNearlyFull(State& state){
+	state.grid.reset(new Grid(state.rows, state.columns));
+	fillGrid(state, *state.grid, 0.9);
+}
+
+// A game of the given kind on a half full grid, with both players
+void setupGame(State& state, Game* game){
+	setupHalfFull(state);
+	state.game.reset(game);
+	state.game->setGrid(state.grid.release());
+	state.game->setPlayerOne(&state.one);
+	state.game->setPlayerTwo(&state.two);
+}
+
+void setupEmpty(State& state){
+	state.grid.reset(new Grid(state.rows, state.columns));
+}
+
+void setupGameScan(State& state){
+	setupGame(state, new Game());
+	state.game->setWinCheck(Game::WC_SCAN);
+}
+
+void setupGameBitboard(State& state){
+	setupGame(state, new Game());
+}
+
+void setupPlayGame(State& state){
+	setupGame(state, new Game());
+	state.game->restart();
+}
+
+void setupPlaySuperGame(State& state){
+	setupGame(state, new SuperGame());
+	state.game->restart();
+}
+
+void benchConstruct(State& state, unsigned long long count){
+	for(unsigned long long i = 0; i < count; i++){
+		Grid grid(state.rows, state.columns);
+		state.sink += grid.discCount();
+	}
+}
+
+void benchInsertDisc(State& state, unsigned long long count){
+	// Fill the columns in turn, emptying the grid once it's full
+	Grid& grid = *state.grid;
+	for(unsigned long long i = 0; i < count; i++){
+		if(grid.noMoreMoves()){
+			grid.reset();
+		}
+		unsigned int column = i % state.columns;
+		while(grid.isColumnFull(column)){
+			column = (column + 1) % state.columns;
+		}
+		state.sink += grid.insertDisc(column, (i & 1) ? Grid::GC_PLAYER_TWO : Grid::GC_PLAYER_ONE);
+	}
+}
+
+void benchCellAt(State& state, unsigned long long count){
+	for(unsigned long long i = 0; i < count; i++){
+		unsigned int k = i & 4095;
+		state.sink += state.grid->cellAt(state.cellRows[k], state.cellColumns[k]);
+	}
+}
+
+void benchReset(State& state, unsigned long long count){
+	for(unsigned long long i = 0; i < count; i++){
+		state.grid->reset();
+		state.sink += state.grid->discCount();
+	}
+}
+
+void benchCopyRow(State& state, unsigned long long count){
+	vector<Grid::Cell> cells;
+	for(unsigned long long i = 0; i < count; i++){
+		state.grid->copyRow(i % state.rows, cells);
+		state.sink += cells[i % state.columns];
+	}
+}
+
+void benchCopyColumn(State& state, unsigned long long count){
+	vector<Grid::Cell> cells;
+	for(unsigned long long i = 0; i < count; i++){
+		state.grid->copyColumn(i % state.columns, cells);
+		state.sink += cells[i % state.rows];
+	}
+}
+
+void benchNoMoreMoves(State& state, unsigned long long count){
+	for(unsigned long long i = 0; i < count; i++){
+		state.sink += state.grid->noMoreMoves();
+	}
+}
+
+void benchFallDown(State& state, unsigned long long count){
+	// Knock a hole into the bottom of one column, let the column fall and top it up again
+	Grid& grid = *state.grid;
+	for(unsigned long long i = 0; i < count; i++){
+		unsigned int column = i % state.columns;
+		if(grid.columnHeight(column) == 0){
+			grid.insertDisc(column, Grid::GC_PLAYER_ONE);
+		}
+		grid.makeEmptyCell(column, state.rows - 1);
+		grid.fallDown();
+		state.sink += grid.insertDisc(column, Grid::GC_PLAYER_TWO);
+	}
+}
+
+void benchFallDownEveryColumn(State& state, unsigned long long count){
+	// Knock a hole into the bottom of every column, let them all fall and top them up again
+	Grid& grid = *state.grid;
+	for(unsigned long long i = 0; i < count; i++){
+		for(unsigned int column = 0; column < state.columns; column++){
+			if(grid.columnHeight(column) == 0){
+				grid.insertDisc(column, Grid::GC_PLAYER_ONE);
+			}
+			grid.makeEmptyCell(column, state.rows - 1);
+		}
+		grid.fallDown();
+		for(unsigned int column = 0; column < state.columns; column++){
+			state.sink += grid.insertDisc(column, Grid::GC_PLAYER_TWO);
+		}
+	}
+}
+
+void benchConnectsFour(State& state, unsigned long long count){
+	for(unsigned long long i = 0; i < count; i++){
+		unsigned int k = i & 4095;
+		unsigned int row = state.cellRows[k];
+		unsigned int column = state.cellColumns[k];
+		state.sink += state.grid->connectsFour(row, column, state.grid->cellAt(row, column));
+	}
+}
+
+void benchCheckForWinner(State& state, unsigned long long count){
+	// The disc on top of each column in turn, as checked after a move
+	Game& game = *state.game;
+	const Grid& grid = *game.grid();
+	for(unsigned long long i = 0; i < count; i++){
+		unsigned int column = i % state.columns;
+		Grid::Cell disc = grid.cellAt(state.rows - grid.columnHeight(column), column);
+		if(disc != Grid::GC_EMPTY){
+			state.sink += game.checkForWinner(column, disc);
+		}
+	}
+}
+
+// The cell by cell checks in one direction, through random cells holding a disc
+template <bool (Game::*check)(int, int, Grid::Cell) const>
+void benchCheckCombo(State& state, unsigned long long count){
+	const Game& game = *state.game;
+	const Grid& grid = *game.grid();
+	for(unsigned long long i = 0; i < count; i++){
+		unsigned int k = i & 4095;
+		int x = state.cellColumns[k];
+		int y = state.cellRows[k];
+		state.sink += (game.*check)(x, y, grid.cellAt(y, x));
+	}
+}
+
+void benchPlayNextTurn(State& state, unsigned long long count){
+	// Random moves, starting again whenever the game is over
+	Game& game = *state.game;
+	for(unsigned long long i = 0; i < count; i++){
+		if(game.status() != Game::GS_IN_PROGRESS){
+			game.restart();
+		}
+		unsigned int column = nextRandom(state, state.columns);
+		while(game.grid()->isColumnFull(column)){
+			column = (column + 1) % state.columns;
+		}
+		state.sink += game.playNextTurn(column);
+	}
+}
+
+void benchPlayout(State& state, unsigned long long count){
+	// Whole random games from the empty grid
+	Position position(*state.grid);
+	for(unsigned long long i = 0; i < count; i++){
+		state.sink += state.playout.play(position);
+	}
+}
+
+// A batch of 1024 games on empty grids
+void setupBatch(State& state){
+	state.batch.reset(new GameBatch(1024, state.rows, state.columns));
+	state.choices.assign(state.batch->size(), 0);
+}
+
+void benchBatchStep(State& state, unsigned long long count){
+	// Random moves in every game at once, restarting the games that are over; an operation is one disc played
+	GameBatch& batch = *state.batch;
+	unsigned long long played = 0;
+	while(played < count){
+		batch.chooseRandomColumns(&state.choices[0], state.random);
+		played += batch.step(&state.choices[0]);
+		batch.restartFinished();
+	}
+	state.sink += played;
+}
+
+// Grids small enough to generate an endgame database for in a moment
+bool fitsEndgames(unsigned int rows, unsigned int columns){
+	return Position::fits(rows, columns) && max(rows, 4u) * max(columns, 4u) <= 20;
+}
+
+// A database for the grid size, and 4096 random positions in it
+void setupEndgames(State& state){
+	const char* path = "c4_bench_endgame.bin";
+	state.endgames.reset(new EndgameDatabase());
+	if(!EndgameDatabase::generate(path, state.rows, state.columns) || !state.endgames->open(path)){
+		cerr << "can't write an endgame database to " << path << endl;
+		exit(1);
+	}
+	remove(path);	// the mapping outlives the file
+	state.positions.clear();
+	while(state.positions.size() < 4096){
+		Position position(state.rows, state.columns);
+		unsigned int moves = nextRandom(state, position.rowCount() * position.columnCount());
+		while(position.moveCount() < moves){
+			unsigned int column = nextRandom(state, position.columnCount());
+			if(!position.canPlay(column) || position.isWinningMove(column)){
+				break;
+			}
+			position.play(column);
+		}
+		if(position.moveCount() < position.rowCount() * position.columnCount()){
+			state.positions.push_back(position);
+		}
+	}
+}
+
+void benchEndgameProbe(State& state, unsigned long long count){
+	EndgameDatabase::Outcome outcome = EndgameDatabase::EO_DRAW;
+	for(unsigned long long i = 0; i < count; i++){
+		state.sink += state.endgames->probe(state.positions[i & 4095], outcome) + outcome;
+	}
+}
+
+struct Benchmark {
+	const char* name;
+	void (*setup)(State&);
+	void (*body)(State&, unsigned long long);
+	bool (*fits)(unsigned int, unsigned int);	// the grid sizes the benchmark runs on, or null for every size
+};
+
+const Benchmark benchmarks[] = {
+	{ "Grid::Grid", setupEmpty, benchConstruct, 0 },
+	{ "Grid::insertDisc", setupEmpty, benchInsertDisc, 0 },
+	{ "Grid::cellAt", setupHalfFull, benchCellAt, 0 },
+	{ "Grid::copyRow", setupHalfFull, benchCopyRow, 0 },
+	{ "Grid::copyColumn", setupHalfFull, benchCopyColumn, 0 },
+	{ "Grid::reset", setupHalfFull, benchReset, 0 },
+	{ "Grid::noMoreMoves", setupHalfFull, benchNoMoreMoves, 0 },
+	{ "Grid::fallDown (one column)", setupNearlyFull, benchFallDown, 0 },
+	{ "Grid::fallDown (every column)", setupNearlyFull, benchFallDownEveryColumn, 0 },
+	{ "Grid::connectsFour", setupHalfFull, benchConnectsFour, 0 },
+	{ "Game::checkForWinner (bitboard)", setupGameBitboard, benchCheckForWinner, 0 },
+	{ "Game::checkForWinner (scan)", setupGameScan, benchCheckForWinner, 0 },
+	{ "Game::check_horizontal_combo", setupGameScan, benchCheckCombo<&Game::check_horizontal_combo>, 0 },
+	{ "Game::check_vertical_combo", setupGameScan, benchCheckCombo<&Game::check_vertical_combo>, 0 },
+	{ "Game::check_diagonal_combo_NW_SE", setupGameScan, benchCheckCombo<&Game::check_diagonal_combo_NW_SE>, 0 },
+	{ "Game::check_diagonal_combo_SW_NE", setupGameScan, benchCheckCombo<&Game::check_diagonal_combo_SW_NE>, 0 },
+	{ "Game::playNextTurn", setupPlayGame, benchPlayNextTurn, 0 },
+	{ "SuperGame::playNextTurn", setupPlaySuperGame, benchPlayNextTurn, 0 },
+	{ "GameBatch::step", setupBatch, benchBatchStep, Position::fits },
+	{ "Playout::play", setupEmpty, benchPlayout, Position::fits },
+	{ "EndgameDatabase::probe", setupEndgames, benchEndgameProbe, fitsEndgames },
+};
+
+// Time `count` operations of the benchmark, in nanoseconds
+double timeBody(const Benchmark& benchmark, State& state, unsigned long long count){
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	benchmark.body(state, count);
+	return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+// Value at the given fraction of the way through the sorted samples (nearest rank)
+double percentile(const vector<double>& sorted, double fraction){
+	unsigned int index = (unsigned int)(fraction * (sorted.size() - 1) + 0.5);
+	return sorted[index];
+}
+
+void run(const Benchmark& benchmark, unsigned int rows, unsigned int columns, unsigned int repetitions,
+		 double target){
+	State state;
+	state.rows = rows;
+	state.columns = columns;
+	state.random = 0x9E3779B97F4A7C15ULL;
+	state.sink = 0;
+	benchmark.setup(state);
+
+	// Double the operations until a repetition takes at least a tenth of the target, then scale up to the target
+	unsigned long long count = 1;
+	double elapsed = timeBody(benchmark, state, count);
+	while(elapsed < target / 10 && count < (1ULL << 40)){
+		count *= 2;
+		elapsed = timeBody(benchmark, state, count);
+	}
+	count = max(1ULL, (unsigned long long)(count * target / max(elapsed, 1.0)));
+	timeBody(benchmark, state, count);	// warm up
+
+	vector<double> samples;
+	for(unsigned int i = 0; i < repetitions; i++){
+		samples.push_back(timeBody(benchmark, state, count) / count);
+	}
+	sort(samples.begin(), samples.end());
+	cout << left << setw(34) << benchmark.name << right << setw(11)
+		 << (to_string(rows) + "x" + to_string(columns)) << fixed << setprecision(1) << setw(12)
+		 << percentile(samples, 0.5) << setw(12) << percentile(samples, 0.1) << setw(12) << percentile(samples, 0.9)
+		 << setw(12) << count << (state.sink == 42 ? " " : "") << endl;
+}
+
+int main(int argc, char const* argv[]){
+	vector<pair<unsigned int, unsigned int> > sizes;
+	string sizeList = "4x4,6x7,20x20,100x100,1000x1000";
+	string filter;
+	unsigned int repetitions = 15;
+	double milliseconds = 20;
+	for(int i = 1; i + 1 < argc; i += 2){
+		if(strcmp(argv[i], "-s") == 0){
+			sizeList = argv[i + 1];
+		} else if(strcmp(argv[i], "-f") == 0){
+			filter = argv[i + 1];
+		} else if(strcmp(argv[i], "-n") == 0){
+			repetitions = max(1, atoi(argv[i + 1]));
+		} else if(strcmp(argv[i], "-t") == 0){
+			milliseconds = max(1, atoi(argv[i + 1]));
+		} else {
+			cerr << "unknown option " << argv[i] << " " << argv[i + 1] << endl;
+			return 1;
+		}
+	}
+	size_t start = 0;
+	while(start < sizeList.size()){
+		size_t end = sizeList.find(',', start);
+		if(end == string::npos){
+			end = sizeList.size();
+		}
+		string size = sizeList.substr(start, end - start);
+		size_t cross = size.find('x');
+		if(cross == string::npos){
+			cerr << "invalid size " << size << endl;
+			return 1;
+		}
+		sizes.push_back(make_pair(atoi(size.substr(0, cross).c_str()), atoi(size.substr(cross + 1).c_str())));
+		start = end + 1;
+	}
+
+	cout << left << setw(34) << "benchmark" << right << setw(11) << "size" << setw(12) << "median ns" << setw(12)
+		 << "p10 ns" << setw(12) << "p90 ns" << setw(12) << "ops/rep" << endl;
+	for(unsigned int b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++){
+		if(string(benchmarks[b].name).find(filter) == string::npos){
+			continue;
+		}
+		for(unsigned int s = 0; s < sizes.size(); s++){
+			if(benchmarks[b].fits != 0 && !benchmarks[b].fits(sizes[s].first, sizes[s].second)){
+				continue;
+			}
+			run(benchmarks[b], sizes[s].first, sizes[s].second, repetitions, milliseconds * 1e6);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,102 @@
+// Opening book generator (see OpeningBook). Solves every position of the grid size reachable in up to the given number
+// of moves and writes them to a book file, printing the number of positions held and the time taken. Only the deepest
+// positions are searched, each within the node and time limits given by -n and -t; the rest are worked out from them.
+// On 6x7 those searches take from seconds to minutes each, so the default depth of 4 (568 positions to search) already
+// takes hours; a limit such as -t 1000 bounds the time, leaving out whatever can't be solved within it.
+//
+// With -l, an existing book is opened instead and positions are looked up in it, one per line from standard input,
+// written as the sequence of columns played from an empty grid (numbered from 1, as for c4_solve). Each output line holds
+// the position, its score for the player to move and the best column (also numbered from 1), or "not in book".
+//
+// usage: c4_book -o file [-r rows] [-c columns] [-d depth] [-n node limit] [-t time limit in ms] [-j threads]
+//                [-m table size in MB]
+//        c4_book -l file
+#include "ConnectFour/OpeningBook.hpp"
+#include "ConnectFour/Solver.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char const* argv[]){
+	unsigned int rows = 6;
+	unsigned int columns = 7;
+	unsigned int depth = 4;
+	string output;
+	string lookup;
+	Solver solver;
+	solver.setTableSize(64);
+	for(int i = 1; i + 1 < argc; i += 2){
+		if(strcmp(argv[i], "-o") == 0){
+			output = argv[i + 1];
+		} else if(strcmp(argv[i], "-l") == 0){
+			lookup = argv[i + 1];
+		} else if(strcmp(argv[i], "-r") == 0){
+			rows = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-c") == 0){
+			columns = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-d") == 0){
+			depth = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-n") == 0){
+			solver.setNodeLimit(strtoull(argv[i + 1], 0, 10));
+		} else if(strcmp(argv[i], "-t") == 0){
+			solver.setTimeLimit(atoi(argv[i + 1]));
+		} else if(strcmp(argv[i], "-j") == 0){
+			solver.setThreads(atoi(argv[i + 1]));
+		} else if(strcmp(argv[i], "-m") == 0){
+			solver.setTableSize(atoi(argv[i + 1]));
+		} else {
+			cerr << "unknown option " << argv[i] << " " << argv[i + 1] << endl;
+			return 1;
+		}
+	}
+
+	if(!lookup.empty()){
+		OpeningBook book;
+		if(!book.open(lookup)){
+			cerr << "can't open book " << lookup << endl;
+			return 1;
+		}
+		string line;
+		while(getline(cin, line)){
+			Position position;
+			int score;
+			int column;
+			if(!Position::fromMoves(book.rowCount(), book.columnCount(), line, position)){
+				cout << line << " invalid" << endl;
+			} else if(book.probe(position, score, column)){
+				cout << line << " " << score << " " << column + 1 << endl;
+			} else {
+				cout << line << " not in book" << endl;
+			}
+		}
+		return 0;
+	}
+
+	if(output.empty()){
+		cerr << "usage: c4_book -o file [-r rows] [-c columns] [-d depth] [-n nodes] [-t ms] [-j threads] [-m MB]"
+			 << " | -l file" << endl;
+		return 1;
+	}
+	if(!Position::fits(rows, columns)){
+		cerr << "a " << rows << "x" << columns << " grid is too large to solve" << endl;
+		return 1;
+	}
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	if(!OpeningBook::generate(output, rows, columns, depth, solver)){
+		cerr << "can't write book " << output << endl;
+		return 1;
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	OpeningBook book;
+	if(!book.open(output)){
+		cerr << "can't read back book " << output << endl;
+		return 1;
+	}
+	cout << output << ": " << book.size() << " positions of up to " << book.depth() << " moves on " << book.rowCount()
+		 << "x" << book.columnCount() << " in " << seconds << " s" << endl;
+	return 0;
+}
@@ -0,0 +1,83 @@
+// Endgame database generator (see EndgameDatabase). Solves every position of the grid size and writes them to a
+// database file, printing the number of positions held, the size of the file and the time taken.
+//
+// With -l, an existing database is opened instead and positions are looked up in it, one per line from standard input,
+// written as the sequence of columns played from an empty grid (numbered from 1, as for c4_solve). Each output line holds
+// the position and whether the player to move wins, draws or loses, or "not in database".
+//
+// usage: c4_endgame -o file [-r rows] [-c columns]
+//        c4_endgame -l file
+#include "ConnectFour/EndgameDatabase.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char const* argv[]){
+	unsigned int rows = 4;
+	unsigned int columns = 4;
+	string output;
+	string lookup;
+	for(int i = 1; i + 1 < argc; i += 2){
+		if(strcmp(argv[i], "-o") == 0){
+			output = argv[i + 1];
+		} else if(strcmp(argv[i], "-l") == 0){
+			lookup = argv[i + 1];
+		} else if(strcmp(argv[i], "-r") == 0){
+			rows = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-c") == 0){
+			columns = atoi(argv[i + 1]);
+		} else {
+			cerr << "unknown option " << argv[i] << " " << argv[i + 1] << endl;
+			return 1;
+		}
+	}
+
+	if(!lookup.empty()){
+		EndgameDatabase database;
+		if(!database.open(lookup)){
+			cerr << "can't open database " << lookup << endl;
+			return 1;
+		}
+		const char* names[3] = { "loss", "draw", "win" };
+		string line;
+		while(getline(cin, line)){
+			Position position;
+			EndgameDatabase::Outcome outcome;
+			if(!Position::fromMoves(database.rowCount(), database.columnCount(), line, position)){
+				cout << line << " invalid" << endl;
+			} else if(database.probe(position, outcome)){
+				cout << line << " " << names[outcome] << endl;
+			} else {
+				cout << line << " not in database" << endl;
+			}
+		}
+		return 0;
+	}
+
+	if(output.empty()){
+		cerr << "usage: c4_endgame -o file [-r rows] [-c columns] | -l file" << endl;
+		return 1;
+	}
+	if(!Position::fits(rows, columns)){
+		cerr << "a " << rows << "x" << columns << " grid is too large to solve" << endl;
+		return 1;
+	}
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	if(!EndgameDatabase::generate(output, rows, columns)){
+		cerr << "can't write database " << output << endl;
+		return 1;
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	EndgameDatabase database;
+	if(!database.open(output)){
+		cerr << "can't read back database " << output << endl;
+		return 1;
+	}
+	cout << output << ": " << database.size() << " positions on " << database.rowCount() << "x"
+		 << database.columnCount() << " in " << seconds << " s" << endl;
+	return 0;
+}
@@ -0,0 +1,114 @@
+// Perft benchmark. Counts every sequence of legal moves up to a given depth from a starting position (see Perft) and
+// prints, for each depth from 1, the number of sequences, the number of moves played to count them, the time taken and
+// the moves played per second. The counts are a regression check for any change to the grid or the win checks; the rate
+// is a measure of how fast moves are played and checked.
+//
+// The starting position is given with -p as the columns played from an empty grid, numbered from 1 and separated by
+// commas (e.g. "4,4,5"). With -v the counts of the deepest depth are also split by the first column played.
+//
+// usage: c4_perft [-r rows] [-c columns] [-d depth] [-m game|super] [-k win length] [-w bitboard|scan]
+//                 [-u undo|copy] [-p moves] [-v divide]
+#include "ConnectFour/Perft.hpp"
+#include "ConnectFour/SuperGame.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace std;
+
+// Play the comma separated columns (numbered from 1) onto the game, returning false if a move can't be played
+bool playSequence(Game& game, const string& sequence){
+	size_t start = 0;
+	while(start < sequence.size()){
+		size_t end = sequence.find(',', start);
+		if(end == string::npos){
+			end = sequence.size();
+		}
+		int column = atoi(sequence.substr(start, end - start).c_str()) - 1;
+		if(column < 0 || !game.playNextTurn(column)){
+			return false;
+		}
+		start = end + 1;
+	}
+	return true;
+}
+
+int main(int argc, char const* argv[]){
+	unsigned int rows = 6;
+	unsigned int columns = 7;
+	unsigned int depth = 7;
+	bool super = false;
+	unsigned int winLength = 4;
+	Game::WinCheck winCheck = Game::WC_BITBOARD;
+	Perft::Method method = Perft::PM_UNDO;
+	string moves;
+	bool divide = false;
+	for(int i = 1; i + 1 < argc; i += 2){
+		if(strcmp(argv[i], "-r") == 0){
+			rows = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-c") == 0){
+			columns = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-d") == 0){
+			depth = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-m") == 0 && strcmp(argv[i + 1], "game") == 0){
+			super = false;
+		} else if(strcmp(argv[i], "-m") == 0 && strcmp(argv[i + 1], "super") == 0){
+			super = true;
+		} else if(strcmp(argv[i], "-k") == 0){
+			winLength = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-w") == 0 && strcmp(argv[i + 1], "bitboard") == 0){
+			winCheck = Game::WC_BITBOARD;
+		} else if(strcmp(argv[i], "-w") == 0 && strcmp(argv[i + 1], "scan") == 0){
+			winCheck = Game::WC_SCAN;
+		} else if(strcmp(argv[i], "-u") == 0 && strcmp(argv[i + 1], "undo") == 0){
+			method = Perft::PM_UNDO;
+		} else if(strcmp(argv[i], "-u") == 0 && strcmp(argv[i + 1], "copy") == 0){
+			method = Perft::PM_COPY;
+		} else if(strcmp(argv[i], "-p") == 0){
+			moves = argv[i + 1];
+		} else if(strcmp(argv[i], "-v") == 0 && strcmp(argv[i + 1], "divide") == 0){
+			divide = true;
+		} else {
+			cerr << "unknown option " << argv[i] << " " << argv[i + 1] << endl;
+			return 1;
+		}
+	}
+
+	Player one("One");
+	Player two("Two");
+	unique_ptr<Game> game(super ? new SuperGame() : new Game());
+	game->setGrid(new Grid(rows, columns));
+	game->setPlayerOne(&one);
+	game->setPlayerTwo(&two);
+	game->setWinLength(winLength);
+	game->setWinCheck(winCheck);
+	if(!playSequence(*game, moves)){
+		cerr << "invalid moves " << moves << endl;
+		return 1;
+	}
+
+	Perft perft;
+	perft.setMethod(method);
+	cout << setw(6) << "depth" << setw(16) << "count" << setw(16) << "moves" << setw(12) << "ms" << setw(14)
+		 << "moves/s" << endl;
+	for(unsigned int d = 1; d <= depth; d++){
+		unsigned long long before = perft.movesPlayed();
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		unsigned long long count = perft.count(*game, d);
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		unsigned long long played = perft.movesPlayed() - before;
+		cout << setw(6) << d << setw(16) << count << setw(16) << played << setw(12) << fixed << setprecision(1)
+			 << seconds * 1000 << setw(14) << setprecision(0) << played / (seconds > 0 ? seconds : 1e-9) << endl;
+	}
+	if(divide && depth > 0){
+		vector<unsigned long long> counts = perft.divide(*game, depth);
+		for(unsigned int c = 0; c < counts.size(); c++){
+			cout << "column " << c + 1 << " " << counts[c] << endl;
+		}
+	}
+	return 0;
+}
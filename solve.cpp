@@ -0,0 +1,100 @@
+// Command line front end for the Solver. Reads one position per line from standard input and prints its solution.
+//
+// Positions are written as the sequence of columns played from an empty grid, numbering the columns from 1 (e.g.
+// "4453" is two discs in the fourth column, then one in the fifth and one in the third), and the empty grid as "-".
+// Blank lines are skipped. Each output line holds the position, its score for the player to move, the best column (also
+// numbered from 1), the number of nodes searched and the time taken in milliseconds.
+//
+// With -s, each position is instead solved again with 1, 2, 4, ... threads up to the given count, starting from an empty
+// transposition table each time, and the time taken and speedup over a single thread are printed for each count.
+//
+// With -o, positions held in the given opening book (see c4_book) are answered from the book without searching.
+//
+// usage: c4_solve [-r rows] [-c columns] [-n node limit] [-t time limit in ms] [-m table size in MB] [-j threads]
+//                 [-s max threads] [-o opening book]
+#include "ConnectFour/OpeningBook.hpp"
+#include "ConnectFour/Solver.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+// Solve the position with an increasing number of threads, printing the time taken and speedup for each
+void reportSpeedup(Solver& solver, const Position& position, const string& sequence, unsigned int maxThreads){
+	unsigned int single = 0;
+	for(unsigned int threads = 1; threads <= maxThreads;){
+		solver.setThreads(threads);
+		solver.clearTable();	// start every run from an empty table
+		Solver::Result result = solver.solve(position);
+		if(threads == 1){
+			single = result.milliseconds;
+		}
+		cout << sequence << " threads " << threads << " score " << result.score << " nodes " << result.nodes << " ms "
+			 << result.milliseconds << " speedup " << fixed << setprecision(2)
+			 << (double)(single == 0 ? 1 : single) / (result.milliseconds == 0 ? 1 : result.milliseconds)
+			 << (result.complete ? "" : " incomplete") << endl;
+		// finish on the requested count even if it isn't a power of two
+		threads = (threads * 2 > maxThreads && threads < maxThreads) ? maxThreads : threads * 2;
+	}
+}
+
+int main(int argc, char const* argv[]){
+	unsigned int rows = 6;
+	unsigned int columns = 7;
+	unsigned int speedupThreads = 0;
+	Solver solver;
+	OpeningBook book;
+	for(int i = 1; i + 1 < argc; i += 2){
+		if(strcmp(argv[i], "-r") == 0){
+			rows = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-c") == 0){
+			columns = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-n") == 0){
+			solver.setNodeLimit(strtoull(argv[i + 1], 0, 10));
+		} else if(strcmp(argv[i], "-t") == 0){
+			solver.setTimeLimit(atoi(argv[i + 1]));
+		} else if(strcmp(argv[i], "-m") == 0){
+			solver.setTableSize(atoi(argv[i + 1]));
+		} else if(strcmp(argv[i], "-j") == 0){
+			solver.setThreads(atoi(argv[i + 1]));
+		} else if(strcmp(argv[i], "-s") == 0){
+			speedupThreads = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-o") == 0){
+			if(!book.open(argv[i + 1])){
+				cerr << "can't open book " << argv[i + 1] << endl;
+				return 1;
+			}
+			solver.setBook(&book);
+		} else {
+			cerr << "unknown option " << argv[i] << endl;
+			return 1;
+		}
+	}
+	if(!Position::fits(rows, columns)){
+		cerr << "a " << rows << "x" << columns << " grid is too large to solve" << endl;
+		return 1;
+	}
+
+	string line;
+	while(getline(cin, line)){
+		if(line.empty()){
+			continue;
+		}
+		Position position;
+		if(!Position::fromMoves(rows, columns, line, position)){
+			cout << line << " invalid" << endl;
+			continue;
+		}
+		if(speedupThreads > 0){
+			reportSpeedup(solver, position, line, speedupThreads);
+			continue;
+		}
+		Solver::Result result = solver.solve(position);
+		cout << line << " " << result.score << " " << result.column + 1 << " " << result.nodes << " "
+			 << result.milliseconds << (result.complete ? "" : " incomplete") << endl;
+	}
+	return 0;
+}
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <cctype>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <vector>
 
 // flags to enable tests for the later parts of the assignment
@@ -8,6 +10,7 @@
 #define ENABLE_T2_TESTS
 #define ENABLE_T3_TESTS
 #define ENABLE_T4_TESTS
+#define ENABLE_T5_TESTS
 
 // include headers for classes being tested
 #ifdef ENABLE_T1_TESTS
@@ -21,12 +24,33 @@
 #include "ConnectFour/Player.hpp"
 #include "ConnectFour/Grid.hpp"
 #include "ConnectFour/Game.hpp"
+#include "ConnectFour/Snapshot.hpp"
 #endif /*ENABLE_T3_TESTS*/
 #ifdef ENABLE_T4_TESTS
 #include "ConnectFour/Player.hpp"
 #include "ConnectFour/Grid.hpp"
 #include "ConnectFour/SuperGame.hpp"
 #endif /*ENABLE_T4_TESTS*/
+#ifdef ENABLE_T5_TESTS
+#include "ConnectFour/BasicGame.hpp"
+#include "ConnectFour/Game.hpp"
+#include "ConnectFour/GameBatch.hpp"
+#include "ConnectFour/IterativeDeepening.hpp"
+#include "ConnectFour/MonteCarlo.hpp"
+#include "ConnectFour/OpeningBook.hpp"
+#include "ConnectFour/EndgameDatabase.hpp"
+#include "ConnectFour/Perft.hpp"
+#include "ConnectFour/Playout.hpp"
+#include "ConnectFour/Policy.hpp"
+#include "ConnectFour/Position.hpp"
+#include "ConnectFour/Solver.hpp"
+#include "ConnectFour/SuperGame.hpp"
+#include "ConnectFour/TimeManager.hpp"
+#include "ConnectFour/Tournament.hpp"
+#include "ConnectFour/TranspositionTable.hpp"
+#include <chrono>
+#include <thread>
+#endif /*ENABLE_T5_TESTS*/
 
 using namespace std;
 
@@ -189,6 +213,25 @@ TestResult test_PlayerWins() {
     
     return TR_PASS;
 }
+
+/*
+Test Player score and win count can be taken back down, but never below 0.
+*/
+TestResult test_PlayerDecrease() {
+    Player p1("Nick");
+    p1.increaseScore();
+    p1.increaseWins();
+    p1.decreaseScore();
+    p1.decreaseWins();
+    ASSERT(p1.getScore() == 0);
+    ASSERT(p1.getWins() == 0);
+    p1.decreaseScore();
+    p1.decreaseWins();
+    ASSERT(p1.getScore() == 0);
+    ASSERT(p1.getWins() == 0);
+
+    return TR_PASS;
+}
 #endif /*ENABLE_T1_TESTS*/
 
 #ifdef ENABLE_T2_TESTS
@@ -374,6 +417,399 @@ TestResult test_GridReset() {
     
     return TR_PASS;
 }
+
+/*
+Test a grid large enough that each player's discs span several 64-bit words, including columns that straddle a word
+boundary.
+*/
+TestResult test_GridMultiWord() {
+    Grid grid(9, 12);
+
+    // each column takes 10 bits, so column 6 straddles the first and second words
+    for (unsigned int c = 0; c < 12; ++c) {
+        for (unsigned int r = 0; r < 9; ++r) {
+            ASSERT(grid.insertDisc(c, ((r + c) % 2 == 0) ? Grid::GC_PLAYER_ONE : Grid::GC_PLAYER_TWO));
+        }
+        ASSERT(!grid.insertDisc(c, Grid::GC_PLAYER_ONE));
+    }
+    for (unsigned int c = 0; c < 12; ++c) {
+        for (unsigned int r = 0; r < 9; ++r) {
+            Grid::Cell expected = ((8 - r + c) % 2 == 0) ? Grid::GC_PLAYER_ONE : Grid::GC_PLAYER_TWO;
+            ASSERT(grid.cellAt(r, c) == expected);
+        }
+    }
+    ASSERT(grid.noMoreMoves());
+
+    // out of bounds cells are always empty
+    ASSERT(grid.cellAt(9, 0) == Grid::GC_EMPTY);
+    ASSERT(grid.cellAt(0, 12) == Grid::GC_EMPTY);
+
+    // knock a hole into column 6 and let the discs above it fall down
+    grid.makeEmptyCell(6, 7);
+    ASSERT(!grid.noMoreMoves());
+    grid.fallDown();
+    ASSERT(grid.cellAt(0, 6) == Grid::GC_EMPTY);
+    ASSERT(grid.cellAt(8, 6) == Grid::GC_PLAYER_ONE);
+    ASSERT(grid.cellAt(7, 6) == Grid::GC_PLAYER_ONE);
+    ASSERT(grid.cellAt(6, 6) == Grid::GC_PLAYER_TWO);
+    ASSERT(grid.insertDisc(6, Grid::GC_PLAYER_TWO));
+    ASSERT(grid.cellAt(0, 6) == Grid::GC_PLAYER_TWO);
+    ASSERT(grid.noMoreMoves());
+
+    return TR_PASS;
+}
+/*
+Test removing the top disc of a column undoes inserting it, on grids of one and several bitboard words.
+*/
+TestResult test_GridRemoveDisc() {
+    Grid small(6, 7);
+    ASSERT(small.removeDisc(0) == Grid::GC_EMPTY);
+    ASSERT(small.removeDisc(7) == Grid::GC_EMPTY);
+    ASSERT(small.insertDisc(3, Grid::GC_PLAYER_ONE));
+    ASSERT(small.insertDisc(3, Grid::GC_PLAYER_TWO));
+    ASSERT(small.removeDisc(3) == Grid::GC_PLAYER_TWO);
+    ASSERT(small.cellAt(4, 3) == Grid::GC_EMPTY);
+    ASSERT(small.cellAt(5, 3) == Grid::GC_PLAYER_ONE);
+    ASSERT(small.columnHeight(3) == 1);
+    ASSERT(small.discCount() == 1);
+    ASSERT(small.removeDisc(3) == Grid::GC_PLAYER_ONE);
+    ASSERT(small.discCount() == 0);
+
+    // fill a column that straddles two words, then empty it again from the top
+    Grid large(9, 12);
+    for (unsigned int r = 0; r < 9; ++r) {
+        ASSERT(large.insertDisc(6, (r % 2 == 0) ? Grid::GC_PLAYER_ONE : Grid::GC_PLAYER_TWO));
+    }
+    ASSERT(large.isColumnFull(6));
+    for (unsigned int r = 9; r-- > 0;) {
+        ASSERT(large.removeDisc(6) == ((r % 2 == 0) ? Grid::GC_PLAYER_ONE : Grid::GC_PLAYER_TWO));
+        ASSERT(large.columnHeight(6) == r);
+    }
+    for (unsigned int r = 0; r < 9; ++r) {
+        ASSERT(large.cellAt(r, 6) == Grid::GC_EMPTY);
+    }
+    ASSERT(large.discCount() == 0);
+
+    return TR_PASS;
+}
+
+/*
+Test the column height and disc count bookkeeping through insertions, cleared cells, falling discs and a reset.
+*/
+TestResult test_GridHeights() {
+    Grid grid(4, 5);
+    ASSERT(grid.discCount() == 0);
+    ASSERT(grid.columnHeight(2) == 0);
+    ASSERT(!grid.isColumnFull(2));
+    // out of bounds columns hold nothing and can't take a disc
+    ASSERT(grid.columnHeight(5) == 0);
+    ASSERT(grid.isColumnFull(5));
+
+    for (unsigned int i = 0; i < 4; ++i) {
+        ASSERT(grid.insertDisc(2, Grid::GC_PLAYER_ONE));
+        // the disc just inserted sits on top of the column
+        ASSERT(grid.cellAt(grid.rowCount() - grid.columnHeight(2), 2) == Grid::GC_PLAYER_ONE);
+    }
+    ASSERT(grid.insertDisc(0, Grid::GC_PLAYER_TWO));
+    ASSERT(grid.columnHeight(2) == 4);
+    ASSERT(grid.isColumnFull(2));
+    ASSERT(grid.discCount() == 5);
+
+    // clearing cells frees up space, and falling down keeps the count
+    grid.makeEmptyCell(2, 1);
+    grid.makeEmptyCell(2, 1);
+    ASSERT(grid.columnHeight(2) == 3);
+    ASSERT(!grid.isColumnFull(2));
+    ASSERT(grid.discCount() == 4);
+    grid.fallDown();
+    ASSERT(grid.columnHeight(2) == 3);
+    ASSERT(grid.discCount() == 4);
+    ASSERT(grid.cellAt(0, 2) == Grid::GC_EMPTY);
+
+    grid.reset();
+    ASSERT(grid.columnHeight(2) == 0);
+    ASSERT(grid.discCount() == 0);
+
+    return TR_PASS;
+}
+
+/*
+Test falling down reports exactly the discs that moved, and where they landed.
+*/
+TestResult test_GridFallDownMoved() {
+    Grid grid(5, 4);
+    for (unsigned int i = 0; i < 4; ++i) {
+        grid.insertDisc(1, i % 2 ? Grid::GC_PLAYER_TWO : Grid::GC_PLAYER_ONE);
+    }
+    grid.insertDisc(3, Grid::GC_PLAYER_ONE);
+    grid.insertDisc(3, Grid::GC_PLAYER_TWO);
+    // clear the second disc of column 1, and the bottom of column 3
+    grid.makeEmptyCell(1, 3);
+    grid.makeEmptyCell(3, 4);
+
+    std::vector<std::pair<unsigned int, unsigned int> > moved;
+    grid.fallDown(moved);
+    ASSERT(moved.size() == 3);
+    ASSERT(moved[0] == std::make_pair(3u, 1u));
+    ASSERT(moved[1] == std::make_pair(2u, 1u));
+    ASSERT(moved[2] == std::make_pair(4u, 3u));
+    ASSERT(grid.cellAt(3, 1) == Grid::GC_PLAYER_ONE);
+    ASSERT(grid.cellAt(2, 1) == Grid::GC_PLAYER_TWO);
+    ASSERT(grid.cellAt(4, 3) == Grid::GC_PLAYER_TWO);
+
+    // nothing left to fall
+    moved.clear();
+    grid.fallDown(moved);
+    ASSERT(moved.empty());
+
+    return TR_PASS;
+}
+
+/*
+Test falling down in columns too tall to be read in one go, with gaps and discs spread over several chunks.
+*/
+TestResult test_GridFallDownTall() {
+    Grid grid(150, 4);
+    for (unsigned int i = 0; i < 140; ++i) {
+        grid.insertDisc(2, i % 3 ? Grid::GC_PLAYER_TWO : Grid::GC_PLAYER_ONE);
+    }
+    // clear one disc low down and a run crossing the 64th cell of the column
+    grid.makeEmptyCell(2, 149 - 5);
+    for (unsigned int i = 60; i < 70; ++i) {
+        grid.makeEmptyCell(2, 149 - i);
+    }
+    ASSERT(grid.columnHeight(2) == 129);
+
+    std::vector<std::pair<unsigned int, unsigned int> > moved;
+    grid.fallDown(moved);
+    ASSERT(moved.size() == 129 - 5);
+    ASSERT(moved.front() == std::make_pair(149u - 5, 2u));
+    ASSERT(moved.back() == std::make_pair(149u - 128, 2u));
+    // every disc keeps its order: discs 0-4, 6-59 and 70-139 from the bottom
+    unsigned int slot = 0;
+    for (unsigned int i = 0; i < 140; ++i) {
+        if (i == 5 || (i >= 60 && i < 70)) {
+            continue;
+        }
+        ASSERT(grid.cellAt(149 - slot, 2) == (i % 3 ? Grid::GC_PLAYER_TWO : Grid::GC_PLAYER_ONE));
+        slot++;
+    }
+    for (; slot < 150; ++slot) {
+        ASSERT(grid.cellAt(149 - slot, 2) == Grid::GC_EMPTY);
+    }
+    ASSERT(grid.columnHeight(2) == 129);
+    ASSERT(grid.discCount() == 129);
+
+    return TR_PASS;
+}
+
+/*
+Test copying whole rows and columns out of the grid gives the same cells as cellAt, on a single-word grid and on one
+with columns taller than a word, including a column with a gap left by an emptied cell.
+*/
+TestResult test_GridCopyRowColumn() {
+    Grid small(6, 7);
+    Grid tall(150, 5);
+    Grid* grids[] = { &small, &tall };
+    for (unsigned int g = 0; g < 2; ++g) {
+        Grid& grid = *grids[g];
+        for (unsigned int c = 0; c < grid.columnCount(); ++c) {
+            for (unsigned int i = 0; i < (c * 37) % (grid.rowCount() + 1); ++i) {
+                ASSERT(grid.insertDisc(c, (i * 7 + c) % 3 == 0 ? Grid::GC_PLAYER_ONE : Grid::GC_PLAYER_TWO));
+            }
+        }
+        grid.makeEmptyCell(3, grid.rowCount() - 2);
+
+        std::vector<Grid::Cell> cells;
+        for (unsigned int r = 0; r < grid.rowCount(); ++r) {
+            grid.copyRow(r, cells);
+            ASSERT(cells.size() == grid.columnCount());
+            for (unsigned int c = 0; c < grid.columnCount(); ++c) {
+                ASSERT(cells[c] == grid.cellAt(r, c));
+            }
+        }
+        for (unsigned int c = 0; c < grid.columnCount(); ++c) {
+            grid.copyColumn(c, cells);
+            ASSERT(cells.size() == grid.rowCount());
+            for (unsigned int r = 0; r < grid.rowCount(); ++r) {
+                ASSERT(cells[r] == grid.cellAt(r, c));
+            }
+        }
+
+        // rows and columns outside the grid have no cells
+        grid.copyRow(grid.rowCount(), cells);
+        ASSERT(cells.empty());
+        grid.copyColumn(grid.columnCount(), cells);
+        ASSERT(cells.empty());
+    }
+    ASSERT(small.cellAt(4, 3) == Grid::GC_EMPTY && small.cellAt(3, 3) != Grid::GC_EMPTY);
+
+    return TR_PASS;
+}
+
+/*
+Test a grid far too large to allocate in full behaves like any other: discs land, fall and connect across pages, copies
+compare equal, and reset empties it again.
+*/
+TestResult test_GridSparse() {
+    ASSERT(!Grid(6, 7).isSparse());
+    ASSERT(!Grid(1000, 1000).isSparse());
+    Grid grid(1000, 100000);
+    ASSERT(grid.isSparse());
+    ASSERT(grid.discCount() == 0 && !grid.noMoreMoves());
+    ASSERT(grid.cellAt(999, 99999) == Grid::GC_EMPTY);
+
+    // a row of four across several pages, and a stack crossing words in a single column
+    for (unsigned int c = 49999; c < 50003; ++c) {
+        ASSERT(grid.insertDisc(c, Grid::GC_PLAYER_ONE));
+    }
+    ASSERT(grid.connectsFour(999, 50001, Grid::GC_PLAYER_ONE));
+    ASSERT(!grid.connectsFour(999, 50001, Grid::GC_PLAYER_TWO));
+    for (unsigned int i = 0; i < 200; ++i) {
+        ASSERT(grid.insertDisc(70000, i % 2 ? Grid::GC_PLAYER_TWO : Grid::GC_PLAYER_ONE));
+    }
+    ASSERT(grid.insertDisc(99999, Grid::GC_PLAYER_TWO));
+    ASSERT(grid.discCount() == 205);
+    ASSERT(grid.columnHeight(70000) == 200 && grid.cellAt(800, 70000) == Grid::GC_PLAYER_TWO);
+    ASSERT(grid.cellAt(999, 99999) == Grid::GC_PLAYER_TWO && grid.cellAt(999, 0) == Grid::GC_EMPTY);
+
+    // clear a run across the 64th cell of the stack; only that column falls
+    Grid copy(grid);
+    ASSERT(copy.sameDiscs(grid));
+    for (unsigned int i = 60; i < 70; ++i) {
+        grid.makeEmptyCell(70000, 999 - i);
+    }
+    ASSERT(!copy.sameDiscs(grid));
+    std::vector<std::pair<unsigned int, unsigned int> > moved;
+    grid.fallDown(moved);
+    ASSERT(moved.size() == 190 - 60);
+    ASSERT(moved.front() == std::make_pair(999u - 60, 70000u));
+    std::vector<Grid::Cell> cells;
+    grid.copyColumn(70000, cells);
+    for (unsigned int i = 0; i < 200; ++i) {
+        Grid::Cell expected = i >= 190 ? Grid::GC_EMPTY : ((i < 60 ? i : i + 10) % 2 ? Grid::GC_PLAYER_TWO : Grid::GC_PLAYER_ONE);
+        ASSERT(cells[999 - i] == expected && grid.cellAt(999 - i, 70000) == expected);
+    }
+
+    // the discs alternate, so ten falling ten cells look just like the copy with its top ten discs taken off
+    for (unsigned int i = 0; i < 10; ++i) {
+        copy.removeDisc(70000);
+    }
+    ASSERT(copy.sameDiscs(grid));
+
+    grid.reset();
+    ASSERT(grid.discCount() == 0 && grid.columnHeight(70000) == 0);
+    ASSERT(grid.cellAt(999, 50000) == Grid::GC_EMPTY && grid.cellAt(900, 70000) == Grid::GC_EMPTY);
+    ASSERT(grid.sameDiscs(Grid(1000, 100000)));
+
+    return TR_PASS;
+}
+
+/*
+Test a grid holding more than 2^32 bits per player: cells past that bound must not alias cells below it, whether they
+are read one at a time, a row or column at a time, or through a line check or fallDown.
+*/
+TestResult test_GridHugeIndices() {
+    Grid grid(1000, 5000000);
+    ASSERT(grid.isSparse());
+    // column 4500000 starts past bit 2^32; with 32-bit indices it wrapped onto column 305696
+    ASSERT(grid.insertDisc(4500000, Grid::GC_PLAYER_ONE));
+    ASSERT(grid.cellAt(999, 4500000) == Grid::GC_PLAYER_ONE);
+    ASSERT(grid.cellAt(999, 305696) == Grid::GC_EMPTY);
+    ASSERT(grid.columnHeight(305696) == 0);
+    std::vector<Grid::Cell> cells;
+    grid.copyRow(999, cells);
+    ASSERT(cells.size() == 5000000 && cells[4500000] == Grid::GC_PLAYER_ONE && cells[305696] == Grid::GC_EMPTY);
+    grid.copyColumn(305696, cells);
+    ASSERT(cells[999] == Grid::GC_EMPTY);
+
+    for (unsigned int c = 4500001; c < 4500004; ++c) {
+        ASSERT(grid.insertDisc(c, Grid::GC_PLAYER_ONE));
+    }
+    ASSERT(grid.connectsFour(999, 4500002, Grid::GC_PLAYER_ONE));
+    ASSERT(grid.connectsLine(999, 4500000, Grid::GC_PLAYER_ONE, 4) && !grid.connectsLine(999, 4500000, Grid::GC_PLAYER_ONE, 5));
+    ASSERT(!grid.connectsFour(999, 305697, Grid::GC_PLAYER_ONE));
+
+    ASSERT(grid.insertDisc(4999999, Grid::GC_PLAYER_TWO));
+    ASSERT(grid.insertDisc(4999999, Grid::GC_PLAYER_ONE));
+    grid.makeEmptyCell(4999999, 999);
+    grid.fallDown();
+    ASSERT(grid.cellAt(999, 4999999) == Grid::GC_PLAYER_ONE && grid.cellAt(998, 4999999) == Grid::GC_EMPTY);
+    ASSERT(grid.discCount() == 5);
+
+    return TR_PASS;
+}
+
+/*
+Test grids whose columns are padded to whole words or powers of two against a plain array of cells: every cell and
+every four in a row must match after discs are dropped at random, some cleared and the rest fallen down.
+*/
+TestResult test_GridPaddedColumns() {
+    unsigned int sizes[][2] = { { 20, 20 }, { 31, 9 }, { 63, 5 }, { 64, 5 }, { 65, 6 }, { 130, 5 } };
+    unsigned int seed = 7;
+    for (unsigned int s = 0; s < 6; ++s) {
+        unsigned int rows = sizes[s][0];
+        unsigned int columns = sizes[s][1];
+        Grid grid(rows, columns);
+        std::vector<std::vector<Grid::Cell> > cells(rows, std::vector<Grid::Cell>(columns, Grid::GC_EMPTY));
+        std::vector<unsigned int> heights(columns, 0);
+        for (unsigned int i = 0; i < rows * columns * 3 / 4; ++i) {
+            seed = seed * 1103515245 + 12345;
+            unsigned int column = (seed >> 16) % columns;
+            Grid::Cell disc = (seed >> 8) % 3 == 0 ? Grid::GC_PLAYER_TWO : Grid::GC_PLAYER_ONE;
+            ASSERT(grid.insertDisc(column, disc) == (heights[column] < rows));
+            if (heights[column] < rows) {
+                cells[rows - 1 - heights[column]][column] = disc;
+                heights[column]++;
+            }
+        }
+        // clear a cell low down in every other column and let the rest fall
+        for (unsigned int c = 0; c < columns; c += 2) {
+            if (heights[c] > 2) {
+                grid.makeEmptyCell(c, rows - 2);
+                for (unsigned int r = rows - 2; r > rows - heights[c]; --r) {
+                    cells[r][c] = cells[r - 1][c];
+                }
+                cells[rows - heights[c]][c] = Grid::GC_EMPTY;
+                heights[c]--;
+            }
+        }
+        grid.fallDown();
+
+        for (unsigned int r = 0; r < rows; ++r) {
+            for (unsigned int c = 0; c < columns; ++c) {
+                ASSERT(grid.cellAt(r, c) == cells[r][c]);
+                Grid::Cell disc = cells[r][c];
+                if (disc == Grid::GC_EMPTY) {
+                    continue;
+                }
+                // count the run through the cell in each direction
+                int steps[4][2] = { { 1, 0 }, { 0, 1 }, { 1, 1 }, { 1, -1 } };
+                bool four = false;
+                for (unsigned int d = 0; d < 4; ++d) {
+                    int run = 1;
+                    for (int sign = -1; sign <= 1; sign += 2) {
+                        int y = r + sign * steps[d][0];
+                        int x = c + sign * steps[d][1];
+                        while (y >= 0 && y < (int)rows && x >= 0 && x < (int)columns && cells[y][x] == disc) {
+                            run++;
+                            y += sign * steps[d][0];
+                            x += sign * steps[d][1];
+                        }
+                    }
+                    four = four || run >= 4;
+                }
+                ASSERT(grid.connectsFour(r, c, disc) == four);
+            }
+        }
+        for (unsigned int c = 0; c < columns; ++c) {
+            ASSERT(grid.columnHeight(c) == heights[c]);
+        }
+    }
+
+    return TR_PASS;
+}
+
 #endif /*ENABLE_T2_TESTS*/
 
 #ifdef ENABLE_T3_TESTS
@@ -957,6 +1393,273 @@ TestResult test_DiagUp() {
 
 }
 
+/*
+Test that the bitboard and cell scanning win checks agree, by playing the same pseudo-random games side by side with
+each method. The 9x12 grid spans several bitboard words so the windowed check is exercised too.
+*/
+TestResult test_GameWinCheckModes() {
+    unsigned int sizes[2][2] = { { 6, 7 }, { 9, 12 } };
+    unsigned int seed = 12345;
+    unsigned int wins = 0;
+    for (unsigned int s = 0; s < 2; ++s) {
+        for (unsigned int g = 0; g < 50; ++g) {
+            Game bitboardGame;
+            Game scanGame;
+            bitboardGame.setGrid(new Grid(sizes[s][0], sizes[s][1]));
+            scanGame.setGrid(new Grid(sizes[s][0], sizes[s][1]));
+            Player p1("Nick");
+            Player p2("Nasser");
+            bitboardGame.setPlayerOne(&p1);
+            bitboardGame.setPlayerTwo(&p2);
+            scanGame.setPlayerOne(&p1);
+            scanGame.setPlayerTwo(&p2);
+            scanGame.setWinCheck(Game::WC_SCAN);
+            ASSERT(bitboardGame.winCheck() == Game::WC_BITBOARD);
+
+            while (bitboardGame.status() == Game::GS_IN_PROGRESS) {
+                seed = seed * 1103515245 + 12345;
+                unsigned int column = (seed >> 16) % sizes[s][1];
+                ASSERT(bitboardGame.playNextTurn(column) == scanGame.playNextTurn(column));
+                ASSERT(bitboardGame.status() == scanGame.status());
+            }
+            ASSERT(bitboardGame.winner() == scanGame.winner());
+            if (bitboardGame.winner() != 0) {
+                ++wins;
+            }
+        }
+    }
+    // make sure the games actually exercised the win checks
+    ASSERT(wins > 50);
+
+    return TR_PASS;
+}
+
+/*
+Test other win lengths: the bitboard and cell scanning win checks must still agree for lines from 3 to 8 long, on grids
+that fit a single bitboard word and on ones that don't, and out of range lengths are corrected.
+*/
+TestResult test_GameWinLength() {
+    Game game;
+    ASSERT(game.winLength() == 4);
+    game.setWinLength(1);
+    ASSERT(game.winLength() == 2);
+    game.setWinLength(1000);
+    ASSERT(game.winLength() == Grid::MAX_LINE_LENGTH);
+
+    unsigned int sizes[3][2] = { { 6, 7 }, { 9, 12 }, { 20, 20 } };
+    unsigned int lengths[4] = { 3, 5, 6, 8 };
+    unsigned int seed = 54321;
+    for (unsigned int s = 0; s < 3; ++s) {
+        for (unsigned int l = 0; l < 4; ++l) {
+            unsigned int wins = 0;
+            for (unsigned int g = 0; g < 20; ++g) {
+                Game bitboardGame;
+                Game scanGame;
+                bitboardGame.setGrid(new Grid(sizes[s][0], sizes[s][1]));
+                scanGame.setGrid(new Grid(sizes[s][0], sizes[s][1]));
+                Player p1("Nick");
+                Player p2("Nasser");
+                bitboardGame.setPlayerOne(&p1);
+                bitboardGame.setPlayerTwo(&p2);
+                scanGame.setPlayerOne(&p1);
+                scanGame.setPlayerTwo(&p2);
+                scanGame.setWinCheck(Game::WC_SCAN);
+                bitboardGame.setWinLength(lengths[l]);
+                scanGame.setWinLength(lengths[l]);
+
+                while (bitboardGame.status() == Game::GS_IN_PROGRESS) {
+                    // favour a few neighbouring columns so long lines actually get made
+                    seed = seed * 1103515245 + 12345;
+                    unsigned int column = ((seed >> 16) % 5 + g) % sizes[s][1];
+                    while (bitboardGame.grid()->isColumnFull(column)) {
+                        column = (column + 1) % sizes[s][1];
+                    }
+                    ASSERT(bitboardGame.playNextTurn(column) == scanGame.playNextTurn(column));
+                    ASSERT(bitboardGame.status() == scanGame.status());
+                }
+                ASSERT(bitboardGame.winner() == scanGame.winner());
+                if (bitboardGame.winner() != 0) {
+                    ++wins;
+                }
+            }
+            // make sure the games actually exercised the win checks, where the line fits in a column
+            ASSERT(wins > 0 || lengths[l] > sizes[s][0]);
+        }
+    }
+
+    // five in a row is needed, four isn't enough
+    Game longGame;
+    longGame.setGrid(new Grid(6, 7));
+    Player p1("Nick");
+    Player p2("Nasser");
+    longGame.setPlayerOne(&p1);
+    longGame.setPlayerTwo(&p2);
+    longGame.setWinLength(5);
+    unsigned int moves[] = { 0, 0, 1, 1, 2, 2, 3, 3 };
+    for (unsigned int i = 0; i < 8; ++i) {
+        ASSERT(longGame.playNextTurn(moves[i]));
+    }
+    ASSERT(longGame.status() == Game::GS_IN_PROGRESS);
+    ASSERT(longGame.playNextTurn(4));
+    ASSERT(longGame.status() == Game::GS_COMPLETE);
+    ASSERT(longGame.winner() == &p1);
+
+    return TR_PASS;
+}
+
+/*
+Test taking moves back: play pseudo-random games to the end, then undo every move, checking the grid, status, winner and
+scores match what they were before each move.
+*/
+TestResult test_GameUndoMove() {
+    unsigned int seed = 2468;
+    for (unsigned int g = 0; g < 30; ++g) {
+        Game game;
+        Player p1("Nick");
+        Player p2("Nasser");
+        game.setGrid(new Grid(4, 5));
+        game.setPlayerOne(&p1);
+        game.setPlayerTwo(&p2);
+        ASSERT(!game.undoMove());
+
+        // snapshots of the state before each move
+        std::vector<std::vector<Grid::Cell> > cells;
+        std::vector<const Player*> nextPlayers;
+        std::vector<unsigned int> scores;
+        while (game.status() == Game::GS_IN_PROGRESS) {
+            std::vector<Grid::Cell> snapshot;
+            for (unsigned int r = 0; r < 4; ++r) {
+                for (unsigned int c = 0; c < 5; ++c) {
+                    snapshot.push_back(game.grid()->cellAt(r, c));
+                }
+            }
+            cells.push_back(snapshot);
+            nextPlayers.push_back(game.nextPlayer());
+            scores.push_back(p1.getScore() * 100 + p2.getScore());
+            seed = seed * 1103515245 + 12345;
+            unsigned int column = (seed >> 16) % 5;
+            while (game.grid()->isColumnFull(column)) {
+                column = (column + 1) % 5;
+            }
+            ASSERT(game.playNextTurn(column));
+        }
+        ASSERT(game.undoableMoves() == cells.size());
+        ASSERT(p1.getWins() + p2.getWins() <= 1);
+
+        while (!cells.empty()) {
+            ASSERT(game.undoMove());
+            ASSERT(game.status() == Game::GS_IN_PROGRESS);
+            ASSERT(game.winner() == 0);
+            ASSERT(game.nextPlayer() == nextPlayers.back());
+            ASSERT(p1.getScore() * 100 + p2.getScore() == scores.back());
+            for (unsigned int r = 0; r < 4; ++r) {
+                for (unsigned int c = 0; c < 5; ++c) {
+                    ASSERT(game.grid()->cellAt(r, c) == cells.back()[r * 5 + c]);
+                }
+            }
+            cells.pop_back();
+            nextPlayers.pop_back();
+            scores.pop_back();
+        }
+        ASSERT(!game.undoMove());
+        ASSERT(game.grid()->discCount() == 0);
+        ASSERT(p1.getWins() == 0 && p2.getWins() == 0);
+    }
+
+    // a win can be taken back and then played again, or the game continued differently
+    Game game;
+    Player p1("Nick");
+    Player p2("Nasser");
+    game.setGrid(new Grid(6, 7));
+    game.setPlayerOne(&p1);
+    game.setPlayerTwo(&p2);
+    unsigned int moves[] = { 0, 1, 0, 1, 0, 1, 0 };
+    for (unsigned int i = 0; i < 7; ++i) {
+        ASSERT(game.playNextTurn(moves[i]));
+    }
+    ASSERT(game.winner() == &p1);
+    ASSERT(game.undoMove());
+    ASSERT(game.nextPlayer() == &p1);
+    ASSERT(p1.getWins() == 0);
+    ASSERT(game.playNextTurn(2));
+    ASSERT(game.playNextTurn(1));
+    ASSERT(game.winner() == &p2);
+    ASSERT(p2.getWins() == 1);
+    game.restart();
+    ASSERT(game.undoableMoves() == 0);
+    ASSERT(!game.undoMove());
+    return TR_PASS;
+}
+
+/*
+Test a Snapshot copies a game's state by value and restores it into the same or another game, and is invalid for games
+it can't hold.
+*/
+TestResult test_GameSnapshot() {
+    ASSERT(sizeof(Snapshot) <= 40);
+    Game game;
+    ASSERT(!game.snapshot().valid());
+    Player p1("Nick");
+    Player p2("Nasser");
+    game.setPlayerOne(&p1);
+    game.setPlayerTwo(&p2);
+    game.setGrid(new Grid(6, 7));
+    game.setWinLength(5);
+
+    unsigned int moves[] = { 0, 0, 1, 1, 2, 2, 3, 3, 4 };
+    for (unsigned int i = 0; i < 8; ++i) {
+        ASSERT(game.playNextTurn(moves[i]));
+    }
+    Snapshot taken = game.snapshot();
+    ASSERT(taken.valid());
+    // a snapshot is plain data, so a byte copy is a complete copy
+    Snapshot copy;
+    memcpy(&copy, &taken, sizeof(Snapshot));
+    ASSERT(copy.turnCount() == 8);
+    ASSERT(copy.status() == Game::GS_IN_PROGRESS);
+    ASSERT(copy.winLength() == 5);
+    ASSERT(copy.cellAt(5, 3) == Grid::GC_PLAYER_ONE);
+    ASSERT(copy.cellAt(4, 3) == Grid::GC_PLAYER_TWO);
+    ASSERT(copy.cellAt(0, 0) == Grid::GC_EMPTY);
+
+    // play on to player one's win, then go back
+    ASSERT(game.playNextTurn(moves[8]));
+    ASSERT(game.winner() == &p1);
+    Snapshot finished = game.snapshot();
+    ASSERT(game.restore(copy));
+    ASSERT(game.status() == Game::GS_IN_PROGRESS);
+    ASSERT(game.nextPlayer() == &p1);
+    ASSERT(p1.getScore() == 0);
+    ASSERT(game.undoableMoves() == 0);
+    for (unsigned int r = 0; r < 6; ++r) {
+        for (unsigned int c = 0; c < 7; ++c) {
+            ASSERT(game.grid()->cellAt(r, c) == copy.cellAt(r, c));
+        }
+    }
+    ASSERT(game.grid()->discCount() == 8);
+    ASSERT(game.grid()->columnHeight(3) == 2);
+
+    // a game on a different grid takes on the snapshot's grid
+    Game other;
+    Player p3("Jian");
+    Player p4("Tess");
+    ASSERT(!other.restore(finished));
+    other.setPlayerOne(&p3);
+    other.setPlayerTwo(&p4);
+    other.setGrid(new Grid(9, 12));
+    ASSERT(!other.snapshot().valid());
+    ASSERT(!other.restore(Snapshot()));
+    ASSERT(other.restore(finished));
+    ASSERT(other.grid()->rowCount() == 6);
+    ASSERT(other.grid()->columnCount() == 7);
+    ASSERT(other.status() == Game::GS_COMPLETE);
+    ASSERT(other.winner() == &p3);
+    ASSERT(p3.getScore() == 1);
+    ASSERT(other.winLength() == 5);
+
+    return TR_PASS;
+}
+
 #endif /*ENABLE_T3_TESTS*/
 
 #ifdef ENABLE_T4_TESTS
@@ -1686,9 +2389,1125 @@ TestResult test_SuperGamePlayerSwap() {
     return TR_PASS;
 }
 
+/*
+Test the combo checks measure the line through a cell without changing the game, so they work on a const SuperGame.
+*/
+TestResult test_SuperGameComboSpan() {
+    SuperGame game;
+    game.setGrid(new Grid(6, 7));
+    Player p1("Jian");
+    Player p2("Tess");
+    game.setPlayerOne(&p1);
+    game.setPlayerTwo(&p2);
+    // three in a row for player one along the bottom, and two stacked in the last column for player two
+    unsigned int moves[] = { 0, 6, 1, 6, 2 };
+    for (unsigned int i = 0; i < 5; ++i) {
+        ASSERT(game.playNextTurn(moves[i]));
+    }
+
+    const SuperGame& view = game;
+    SuperGame::ComboSpan span;
+    ASSERT(!view.check_horizontal_combo(1, 5, Grid::GC_PLAYER_ONE, span));
+    ASSERT(span.dx == 1 && span.dy == 0);
+    ASSERT(span.forward == 1 && span.backward == 1);
+    // a disc in the gap would make four
+    ASSERT(view.check_horizontal_combo(3, 5, Grid::GC_PLAYER_ONE, span));
+    ASSERT(span.forward == 0 && span.backward == 3);
+    ASSERT(!view.check_vertical_combo(6, 3, Grid::GC_PLAYER_TWO, span));
+    ASSERT(span.forward == 2 && span.backward == 0);
+    ASSERT(!view.check_diagonal_combo_NW_SE(1, 5, Grid::GC_PLAYER_ONE));
+    ASSERT(!view.check_diagonal_combo_SW_NE(1, 5, Grid::GC_PLAYER_ONE));
+    ASSERT(game.grid()->discCount() == 5);
 
+    return TR_PASS;
+}
+
+/*
+Test a SuperGame played to connect three clears lines of three, and only those.
+*/
+TestResult test_SuperGameWinLength() {
+    SuperGame game;
+    game.setGrid(new Grid(6, 7));
+    Player p1("Nick");
+    Player p2("Nasser");
+    game.setPlayerOne(&p1);
+    game.setPlayerTwo(&p2);
+    game.setWinLength(3);
+
+    unsigned int moves[] = { 0, 0, 1, 1 };
+    for (unsigned int i = 0; i < 4; ++i) {
+        ASSERT(game.playNextTurn(moves[i]));
+    }
+    ASSERT(p1.getScore() == 0);
+    ASSERT(game.playNextTurn(2));
+    // player one's bottom row is cleared and player two's two discs fall into it
+    ASSERT(p1.getScore() == 1);
+    ASSERT(p2.getScore() == 0);
+    ASSERT(game.grid()->cellAt(5, 0) == Grid::GC_PLAYER_TWO);
+    ASSERT(game.grid()->cellAt(5, 1) == Grid::GC_PLAYER_TWO);
+    ASSERT(game.grid()->cellAt(5, 2) == Grid::GC_EMPTY);
+    ASSERT(game.grid()->discCount() == 2);
+    // cleared lines can't be put back, so SuperGame moves are never taken back
+    ASSERT(!game.undoMove());
+
+    return TR_PASS;
+}
 #endif /*ENABLE_T4_TESTS*/
 
+#ifdef ENABLE_T5_TESTS
+/*
+Helper to play a sequence of columns (numbered from 1, as in standard Connect Four notation) onto a position.
+*/
+Position playMoves(unsigned int rows, unsigned int columns, const std::string& moves) {
+    Position position(rows, columns);
+    for (unsigned int i = 0; i < moves.size(); ++i) {
+        position.play(moves[i] - '1');
+    }
+    return position;
+}
+
+/*
+Test a Position built from a Grid matches the grid, including whose turn it is.
+*/
+TestResult test_PositionFromGrid() {
+    Grid grid(6, 7);
+    ASSERT(grid.insertDisc(3, Grid::GC_PLAYER_ONE));
+    ASSERT(grid.insertDisc(3, Grid::GC_PLAYER_TWO));
+    ASSERT(grid.insertDisc(4, Grid::GC_PLAYER_ONE));
+
+    Position position(grid);
+    ASSERT(position.moveCount() == 3);
+    ASSERT(position.key() == playMoves(6, 7, "445").key());
+    for (unsigned int r = 0; r < 6; ++r) {
+        for (unsigned int c = 0; c < 7; ++c) {
+            ASSERT(position.cellAt(r, c) == grid.cellAt(r, c));
+        }
+    }
+
+    // grids that are too big for a single word can't be turned into a position
+    ASSERT(Position::fits(6, 7));
+    ASSERT(Position::fits(7, 8));
+    ASSERT(!Position::fits(8, 8));
+
+    // move sequences as the tools read them, rejecting moves that can't be played or end the game
+    Position played;
+    ASSERT(Position::fromMoves(6, 7, "445", played) && played.key() == position.key());
+    ASSERT(Position::fromMoves(5, 6, "-", played) && played.moveCount() == 0 && played.columnCount() == 6);
+    ASSERT(!Position::fromMoves(6, 7, "4444444", played));
+    ASSERT(!Position::fromMoves(6, 7, "48", played));
+    ASSERT(!Position::fromMoves(6, 7, "1212121", played));
+
+    return TR_PASS;
+}
+
+/*
+Test the solver takes an immediate win, and blocks the only threat when it can't win straight away.
+*/
+TestResult test_SolverWinAndBlock() {
+    Solver solver;
+
+    // player one has three in the bottom row and wins with their fourth disc
+    Solver::Result result = solver.solve(playMoves(6, 7, "112233"));
+    ASSERT(result.complete);
+    ASSERT(result.column == 3);
+    ASSERT(result.score == (42 + 1 - 6) / 2);
+
+    // two open ends: player two loses whatever they play
+    result = solver.solve(playMoves(6, 7, "44553"));
+    ASSERT(result.complete);
+    ASSERT(result.score == -(42 - 6) / 2);
+
+    // late in the game, known results from standard test positions
+    result = solver.solve(playMoves(6, 7, "2252576253462244111563365343671351441"));
+    ASSERT(result.complete);
+    ASSERT(result.score == -1);
+    result = solver.solve(playMoves(6, 7, "7422341735647741166133573473242566"));
+    ASSERT(result.complete);
+    ASSERT(result.score == 1);
+
+    return TR_PASS;
+}
+
+/*
+Test the solver on a whole 4x4 game, which is a draw with perfect play, and that the best move keeps the draw.
+*/
+TestResult test_SolverSmallBoard() {
+    Solver solver;
+    Position position(4, 4);
+    Solver::Result result = solver.solve(position);
+    ASSERT(result.complete);
+    ASSERT(result.score == 0);
+    ASSERT(position.canPlay(result.column));
+
+    position.play(result.column);
+    ASSERT(solver.solve(position).score == 0);
+
+    return TR_PASS;
+}
+
+/*
+Test the solver works from a Game, and gives up without a move when the game is over or isn't played to four in a row.
+*/
+TestResult test_SolverGame() {
+    Grid* grid = new Grid(6, 7);
+    Game game;
+    game.setGrid(grid);
+    Player p1("Nick");
+    game.setPlayerOne(&p1);
+    Player p2("Nasser");
+    game.setPlayerTwo(&p2);
+
+    // player two to move, and must block column 4
+    ASSERT(game.playNextTurn(3));
+    ASSERT(game.playNextTurn(0));
+    ASSERT(game.playNextTurn(3));
+    ASSERT(game.playNextTurn(0));
+    ASSERT(game.playNextTurn(3));
+    Solver solver;
+    Solver::Result result = solver.solve(game);
+    ASSERT(result.column == 3);
+
+    // let player one win, after which there is nothing to solve
+    ASSERT(game.playNextTurn(6));
+    ASSERT(game.playNextTurn(3));
+    ASSERT(game.status() == Game::GS_COMPLETE);
+    result = solver.solve(game);
+    ASSERT(!result.complete);
+    ASSERT(result.column == -1);
+
+    // other rules than four in a row can't be solved either
+    Game five;
+    five.setGrid(new Grid(6, 7));
+    five.setPlayerOne(&p1);
+    five.setPlayerTwo(&p2);
+    five.setWinLength(5);
+    ASSERT(five.playNextTurn(3));
+    result = solver.solve(five);
+    ASSERT(!result.complete && result.column == -1);
+    SuperGame super;
+    super.setGrid(new Grid(6, 7));
+    super.setPlayerOne(&p1);
+    super.setPlayerTwo(&p2);
+    ASSERT(super.playNextTurn(3));
+    result = solver.solve(super);
+    ASSERT(!result.complete && result.column == -1);
+
+    return TR_PASS;
+}
+
+/*
+Test the solver stops when it runs out of nodes, still suggesting a legal move.
+*/
+TestResult test_SolverBudget() {
+    Solver solver;
+    solver.setNodeLimit(5000);
+    Position position(6, 7);
+    Solver::Result result = solver.solve(position);
+    ASSERT(!result.complete);
+    ASSERT(result.nodes < 10000);
+    ASSERT(position.canPlay(result.column));
+
+    return TR_PASS;
+}
+
+/*
+Test storing and looking up transposition table entries, including replacement in a full bucket.
+*/
+TestResult test_TranspositionTable() {
+    TranspositionTable table(1);
+    ASSERT(table.capacity() == (1 << 20) / 16);
+
+    TranspositionTable::Entry entry;
+    ASSERT(!table.probe(42, entry));
+    table.store(42, -3, TranspositionTable::TB_UPPER, 20, 4);
+    ASSERT(table.probe(42, entry));
+    ASSERT(entry.score == -3);
+    ASSERT(entry.bound == TranspositionTable::TB_UPPER);
+    ASSERT(entry.depth == 20);
+    ASSERT(entry.move == 4);
+
+    // storing the same key again overwrites the old entry
+    table.store(42, 5, TranspositionTable::TB_EXACT, 20, 2);
+    ASSERT(table.probe(42, entry));
+    ASSERT(entry.score == 5);
+    ASSERT(entry.bound == TranspositionTable::TB_EXACT);
+
+    // the empty position (key 0) can be stored too
+    table.store(0, 1, TranspositionTable::TB_LOWER, 42, 3);
+    ASSERT(table.probe(0, entry));
+    ASSERT(entry.score == 1);
+
+    table.clear();
+    ASSERT(!table.probe(42, entry));
+    ASSERT(!table.probe(0, entry));
+
+    // overfill the table with shallow entries: deep entries survive with depth-preferred replacement, but not when
+    // entries are always replaced
+    unsigned int survivors[2] = { 0, 0 };
+    for (unsigned int policy = 0; policy < 2; ++policy) {
+        table.clear();
+        table.setReplacement(policy == 0 ? TranspositionTable::TR_DEPTH_PREFERRED : TranspositionTable::TR_ALWAYS);
+        for (uint64_t key = 1; key <= 1000; ++key) {
+            table.store(key * 1000003, 0, TranspositionTable::TB_EXACT, 40, 0);
+        }
+        for (uint64_t key = 1; key <= 4 * table.capacity(); ++key) {
+            table.store(key * 7919 + 1, 0, TranspositionTable::TB_EXACT, 1, 0);
+        }
+        for (uint64_t key = 1; key <= 1000; ++key) {
+            if (table.probe(key * 1000003, entry) && entry.depth == 40) {
+                ++survivors[policy];
+            }
+        }
+    }
+    ASSERT(survivors[0] == 1000);
+    ASSERT(survivors[1] < 1000);
+
+    // a table without any memory never stores anything
+    TranspositionTable empty(0);
+    ASSERT(empty.capacity() == 0);
+    empty.store(7, 1, TranspositionTable::TB_EXACT, 1, 0);
+    ASSERT(!empty.probe(7, entry));
+
+    return TR_PASS;
+}
+
+/*
+Test the transposition table doesn't change the solver's answers, and saves it a lot of work.
+*/
+TestResult test_SolverTable() {
+    Position position = playMoves(6, 7, "44533445235413");
+    Solver withTable;
+    Solver withoutTable;
+    withoutTable.setTableSize(0);
+    Solver::Result cached = withTable.solve(position);
+    Solver::Result uncached = withoutTable.solve(position);
+    ASSERT(cached.complete && uncached.complete);
+    ASSERT(cached.score == uncached.score);
+    ASSERT(cached.nodes * 4 < uncached.nodes);
+
+    // solving it again reuses the table
+    Solver::Result again = withTable.solve(position);
+    ASSERT(again.score == cached.score);
+    ASSERT(again.column == cached.column);
+    ASSERT(again.nodes < cached.nodes);
+
+    return TR_PASS;
+}
+
+/*
+Test a search on several threads agrees with a single threaded one, and that single threaded searches are repeatable.
+*/
+TestResult test_SolverThreads() {
+    Position position = playMoves(6, 7, "44533445235413");
+    Solver single;
+    Solver::Result first = single.solve(position);
+    single.setTableSize(16);
+    Solver::Result second = single.solve(position);
+    ASSERT(first.complete && second.complete);
+    ASSERT(first.score == second.score);
+    ASSERT(first.column == second.column);
+    ASSERT(first.nodes == second.nodes);
+
+    Solver parallel;
+    parallel.setThreads(4);
+    ASSERT(parallel.threadCount() == 4);
+    Solver::Result result = parallel.solve(position);
+    ASSERT(result.complete);
+    ASSERT(result.score == first.score);
+    // the best move may differ, but it must achieve the same score
+    ASSERT(position.canPlay(result.column));
+    Position child(position);
+    child.play(result.column);
+    ASSERT(-single.solve(child).score == first.score);
+
+    parallel.setThreads(0);
+    ASSERT(parallel.threadCount() >= 1);
+
+    return TR_PASS;
+}
+
+/*
+Test every policy picks a playable column, and the greedy policy takes wins and blocks losses.
+*/
+TestResult test_Policies() {
+    ASSERT(Policy::create("nobody") == 0);
+    const char* names[] = { "random", "centre", "greedy", "solver", "deepening" };
+    for (unsigned int i = 0; i < 5; i++) {
+        Policy* policy = Policy::create(names[i]);
+        ASSERT(policy != 0);
+        ASSERT(policy->name() == names[i]);
+
+        // only the last column has room left
+        Player one("One");
+        Player two("Two");
+        Game game;
+        game.setGrid(new Grid(4, 4));
+        game.setPlayerOne(&one);
+        game.setPlayerTwo(&two);
+        unsigned int moves[] = { 0, 1, 0, 1, 1, 0, 1, 0, 2, 2, 2, 2 };
+        for (unsigned int j = 0; j < 12; j++) {
+            ASSERT(game.playNextTurn(moves[j]));
+        }
+        ASSERT(game.status() == Game::GS_IN_PROGRESS);
+        ASSERT(policy->chooseColumn(game, Grid::GC_PLAYER_ONE) == 3);
+        delete policy;
+    }
+
+    GreedyPolicy greedy;
+    Player one("One");
+    Player two("Two");
+    Game game;
+    game.setGrid(new Grid(6, 7));
+    game.setPlayerOne(&one);
+    game.setPlayerTwo(&two);
+    game.playNextTurn(0);
+    game.playNextTurn(6);
+    game.playNextTurn(0);
+    game.playNextTurn(6);
+    game.playNextTurn(0);
+    // player two must block column 0, while player one would win there
+    ASSERT(greedy.chooseColumn(game, Grid::GC_PLAYER_TWO) == 0);
+    ASSERT(greedy.chooseColumn(game, Grid::GC_PLAYER_ONE) == 0);
+    game.playNextTurn(6);
+    ASSERT(greedy.chooseColumn(game, Grid::GC_PLAYER_ONE) == 0);
+
+    return TR_PASS;
+}
+
+/*
+Test a tournament plays every game, and gives the same tallies however many threads it runs on.
+*/
+TestResult test_Tournament() {
+    Tournament tournament("greedy", "random");
+    tournament.setGames(500);
+    tournament.setSeed(7);
+    tournament.setThreads(1);
+    Tournament::Result single = tournament.run();
+    tournament.setThreads(3);
+    Tournament::Result parallel = tournament.run();
+
+    ASSERT(single.games == 500 && parallel.games == 500);
+    ASSERT(single.threads == 1 && parallel.threads == 3);
+    ASSERT(single.moves == parallel.moves);
+    for (unsigned int i = 0; i < 2; i++) {
+        ASSERT(single.tallies[i].wins == parallel.tallies[i].wins);
+        ASSERT(single.tallies[i].losses == parallel.tallies[i].losses);
+        ASSERT(single.tallies[i].draws == parallel.tallies[i].draws);
+        ASSERT(single.tallies[i].score == parallel.tallies[i].score);
+        ASSERT(single.tallies[i].wins + single.tallies[i].losses + single.tallies[i].draws == 500);
+    }
+    ASSERT(single.tallies[0].wins == single.tallies[1].losses);
+    ASSERT(single.tallies[0].wins > single.tallies[1].wins);
+
+    tournament.setMode(Tournament::TM_SUPERGAME);
+    tournament.setGames(50);
+    Tournament::Result super = tournament.run();
+    ASSERT(super.games == 50);
+
+    Tournament unknown("greedy", "nobody");
+    ASSERT(unknown.run().games == 0);
+
+    return TR_PASS;
+}
+/*
+Play the same random games on a BasicGame and on a Game of the same size in lockstep, checking that they always agree,
+and check the compile-time grid on its own for the other supported size.
+*/
+TestResult test_BasicGameMatchesGame() {
+    uint64_t state = 12345;
+    for (unsigned int n = 0; n < 200; n++) {
+        Player one("One");
+        Player two("Two");
+        Game game;
+        game.setGrid(new Grid(6, 7));
+        game.setPlayerOne(&one);
+        game.setPlayerTwo(&two);
+        BasicGame<6, 7> basic;
+        ASSERT(basic.status() == Game::GS_INVALID);
+        basic.setPlayerOne(&one);
+        basic.setPlayerTwo(&two);
+        ASSERT(basic.status() == Game::GS_IN_PROGRESS);
+        while (game.status() == Game::GS_IN_PROGRESS) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            unsigned int column = (state >> 33) % 8;    // column 7 is out of bounds
+            ASSERT(basic.nextPlayer() == game.nextPlayer());
+            ASSERT(basic.playNextTurn(column) == game.playNextTurn(column));
+            ASSERT(basic.status() == game.status());
+            for (unsigned int i = 0; i < 7; i++) {
+                ASSERT(basic.grid().columnHeight(i) == game.grid()->columnHeight(i));
+            }
+        }
+        ASSERT(basic.winner() == game.winner());
+        Grid copy(6, 7);
+        basic.grid().copyTo(copy);
+        for (unsigned int r = 0; r < 6; r++) {
+            for (unsigned int c = 0; c < 7; c++) {
+                ASSERT(copy.cellAt(r, c) == game.grid()->cellAt(r, c));
+                ASSERT(basic.grid().cellAt(r, c) == game.grid()->cellAt(r, c));
+            }
+        }
+    }
+
+    // a diagonal on the 7x8 grid, then a gap closed up by fallDown
+    BasicGrid<7, 8> grid;
+    for (unsigned int i = 0; i < 4; i++) {
+        for (unsigned int j = 0; j < i; j++) {
+            ASSERT(grid.insertDisc(i + 2, Grid::GC_PLAYER_TWO));
+        }
+        ASSERT(grid.insertDisc(i + 2, Grid::GC_PLAYER_ONE));
+    }
+    ASSERT(grid.hasWin(Grid::GC_PLAYER_ONE));
+    ASSERT(!grid.hasWin(Grid::GC_PLAYER_TWO));
+    ASSERT(grid.connectsFour(6, 2, Grid::GC_PLAYER_ONE));
+    ASSERT(grid.connectsFour(3, 5, Grid::GC_PLAYER_ONE));
+    ASSERT(!grid.connectsFour(6, 3, Grid::GC_PLAYER_TWO));
+    grid.makeEmptyCell(5, 6);
+    ASSERT(grid.columnHeight(5) == 3);
+    std::vector<std::pair<unsigned int, unsigned int> > moved;
+    grid.fallDown(moved);
+    ASSERT(moved.size() == 3);
+    ASSERT(grid.cellAt(6, 5) == Grid::GC_PLAYER_TWO);
+    ASSERT(grid.cellAt(5, 5) == Grid::GC_PLAYER_TWO);
+    ASSERT(grid.cellAt(4, 5) == Grid::GC_PLAYER_ONE);
+    ASSERT(grid.cellAt(3, 5) == Grid::GC_EMPTY);
+    ASSERT(!grid.hasWin(Grid::GC_PLAYER_ONE));
+
+    return TR_PASS;
+}
+/*
+Test the perft counts against known values, both by taking moves back and by copying the game, and check counting
+leaves the game and its players as they were.
+*/
+TestResult test_Perft() {
+    Player one("One");
+    Player two("Two");
+    Game game;
+    game.setGrid(new Grid(6, 7));
+    game.setPlayerOne(&one);
+    game.setPlayerTwo(&two);
+    Perft perft;
+    // no game can be won in fewer than 7 moves, and only a full column stops a sequence before that
+    unsigned long long expected[] = { 1, 7, 49, 343, 2401, 16807, 117649 };
+    for (unsigned int d = 0; d < 7; d++) {
+        ASSERT(perft.count(game, d) == expected[d]);
+    }
+    ASSERT(game.grid()->discCount() == 0);
+    ASSERT(game.undoableMoves() == 0);
+
+    // 4x4 counts, checked by an independent brute force search
+    Game small;
+    small.setGrid(new Grid(4, 4));
+    small.setPlayerOne(&one);
+    small.setPlayerTwo(&two);
+    ASSERT(perft.count(small, 8) == 57504);
+    std::vector<unsigned long long> split = perft.divide(small, 8);
+    ASSERT(split.size() == 4);
+    ASSERT(split[0] + split[1] + split[2] + split[3] == 57504);
+    ASSERT(split[0] == split[3] && split[1] == split[2]);
+    perft.setMethod(Perft::PM_COPY);
+    ASSERT(perft.count(small, 8) == 57504);
+    ASSERT(one.getScore() == 0 && one.getWins() == 0);
+    ASSERT(two.getScore() == 0 && two.getWins() == 0);
+
+    // a SuperGame is always counted on copies, and clears lines rather than ending the game
+    SuperGame super;
+    super.setGrid(new Grid(4, 4));
+    super.setPlayerOne(&one);
+    super.setPlayerTwo(&two);
+    perft.setMethod(Perft::PM_UNDO);
+    ASSERT(perft.count(super, 8) == 58512);
+    ASSERT(super.grid()->discCount() == 0);
+    ASSERT(one.getScore() == 0 && two.getScore() == 0);
+
+    // nothing is counted from a finished game
+    unsigned int moves[] = { 0, 1, 0, 1, 0, 1, 0 };
+    for (unsigned int i = 0; i < 7; i++) {
+        ASSERT(small.playNextTurn(moves[i]));
+    }
+    ASSERT(perft.count(small, 1) == 0);
+    ASSERT(perft.count(small, 0) == 1);
+    ASSERT(perft.divide(small, 1).empty());
+
+    return TR_PASS;
+}
+
+/*
+Helper to check every position of up to `depth` moves from `position` is in the book with the solver's score, and that
+the book's move keeps that score.
+*/
+bool checkBook(const OpeningBook& book, Solver& solver, const Position& position, unsigned int depth) {
+    int score;
+    int column;
+    if (!book.probe(position, score, column)) {
+        return false;
+    }
+    if (score != solver.solve(position).score || !position.canPlay(column)) {
+        return false;
+    }
+    if (!position.isWinningMove(column)) {
+        Position child(position);
+        child.play(column);
+        if (child.moveCount() < child.rowCount() * child.columnCount() && -solver.solve(child).score != score) {
+            return false;
+        }
+    }
+    for (unsigned int c = 0; depth > 0 && c < position.columnCount(); ++c) {
+        if (position.canPlay(c) && !position.isWinningMove(c)) {
+            Position child(position);
+            child.play(c);
+            if (!checkBook(book, solver, child, depth - 1)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+Test an opening book holds every position up to its depth with the solved score and a best move, mirrored positions
+included, that positions the solver runs out of budget on are left out, and that the solver and the searching policies
+answer those positions from the book without searching.
+*/
+TestResult test_OpeningBook() {
+    const char* path = "c4_test_book.bin";
+    Solver solver;
+    ASSERT(OpeningBook::generate(path, 4, 5, 4, solver));
+
+    OpeningBook book;
+    ASSERT(book.open(path));
+    ASSERT(book.rowCount() == 4 && book.columnCount() == 5 && book.depth() == 4);
+    ASSERT(book.size() > 0);
+    ASSERT(checkBook(book, solver, Position(4, 5), 4));
+
+    // positions beyond the book's depth or of another size aren't held
+    int score;
+    int column;
+    ASSERT(!book.probe(playMoves(4, 5, "12345"), score, column));
+    ASSERT(!book.probe(Position(4, 4), score, column));
+
+    // mirror images share an entry, with the column mirrored
+    int mirroredScore;
+    int mirroredColumn;
+    ASSERT(book.probe(playMoves(4, 5, "12"), score, column));
+    ASSERT(book.probe(playMoves(4, 5, "54"), mirroredScore, mirroredColumn));
+    ASSERT(score == mirroredScore && column == 4 - mirroredColumn);
+
+    // only the deepest positions are searched, the rest follow from them, on even widths too; a budget too small to
+    // search them leaves out everything that depends on them
+    const char* evenPath = "c4_test_book_even.bin";
+    Solver even;
+    OpeningBook evenBook;
+    ASSERT(OpeningBook::generate(evenPath, 4, 4, 3, even) && evenBook.open(evenPath));
+    ASSERT(checkBook(evenBook, even, Position(4, 4), 3));
+    evenBook.close();
+    even.setNodeLimit(1000);
+    ASSERT(OpeningBook::generate(evenPath, 5, 6, 2, even) && evenBook.open(evenPath));
+    ASSERT(evenBook.depth() == 2 && evenBook.size() < 6);
+    ASSERT(!evenBook.probe(Position(5, 6), score, column));
+    evenBook.close();
+    remove(evenPath);
+
+    Solver booked;
+    booked.setBook(&book);
+    Solver::Result result = booked.solve(playMoves(4, 5, "3"));
+    ASSERT(result.complete && result.nodes == 0);
+    ASSERT(result.score == solver.solve(playMoves(4, 5, "3")).score);
+    result = booked.solve(playMoves(4, 5, "33344"));
+    ASSERT(result.complete && result.nodes > 0);
+
+    // the searching policies play the book's move in every position it holds, but only in standard four in a row
+    // Games: a SuperGame or a longer win length is searched just as without the book
+    MctsPolicy mcts(1);
+    DeepeningPolicy deepening(1);
+    DeepeningPolicy unbooked(1);
+    mcts.setBook(&book);
+    deepening.setBook(&book);
+    Player one("One");
+    Player two("Two");
+    Grid::Cell disc = Grid::GC_PLAYER_ONE;
+    bool differs = false;
+    for (unsigned int first = 0; first < 5; ++first) {
+        for (unsigned int second = 0; second < 5; ++second) {
+            Game game;
+            SuperGame super;
+            Game five;
+            Game* games[] = { &game, &super, &five };
+            five.setWinLength(5);
+            for (unsigned int i = 0; i < 3; ++i) {
+                games[i]->setGrid(new Grid(4, 5));
+                games[i]->setPlayerOne(&one);
+                games[i]->setPlayerTwo(&two);
+                ASSERT(games[i]->playNextTurn(first) && games[i]->playNextTurn(second));
+            }
+            ASSERT(book.probe(Position(*game.grid()), score, column));
+            ASSERT(mcts.chooseColumn(game, disc) == (unsigned int)column);
+            ASSERT(deepening.chooseColumn(game, disc) == (unsigned int)column);
+            ASSERT(deepening.chooseColumn(super, disc) == unbooked.chooseColumn(super, disc));
+            ASSERT(deepening.chooseColumn(five, disc) == unbooked.chooseColumn(five, disc));
+            differs = differs || unbooked.chooseColumn(game, disc) != (unsigned int)column;
+        }
+    }
+    ASSERT(differs);
+
+    // anything that isn't a book is rejected
+    book.close();
+    ASSERT(!book.isOpen());
+    ASSERT(!book.open("c4_test_missing_book.bin"));
+    FILE* file = fopen(path, "wb");
+    ASSERT(file != 0);
+    fputs("not a book at all, but long enough to hold a header", file);
+    fclose(file);
+    ASSERT(!book.open(path));
+    remove(path);
+
+    return TR_PASS;
+}
+
+/*
+Helper to check every position of up to `depth` moves from `position` is in the database with the outcome of the
+solver's score.
+*/
+bool checkEndgames(const EndgameDatabase& database, Solver& solver, const Position& position, unsigned int depth) {
+    EndgameDatabase::Outcome outcome;
+    if (!database.probe(position, outcome)) {
+        return false;
+    }
+    int score = solver.solve(position).score;
+    EndgameDatabase::Outcome expected = score > 0 ? EndgameDatabase::EO_WIN
+                                      : score < 0 ? EndgameDatabase::EO_LOSS : EndgameDatabase::EO_DRAW;
+    if (outcome != expected) {
+        return false;
+    }
+    for (unsigned int c = 0; depth > 0 && c < position.columnCount(); ++c) {
+        if (position.canPlay(c) && !position.isWinningMove(c)) {
+            Position child(position);
+            child.play(c);
+            if (child.moveCount() < child.rowCount() * child.columnCount()
+                && !checkEndgames(database, solver, child, depth - 1)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+Test an endgame database holds every position with the outcome the solver finds, mirrored positions included, that a
+Game of the same size can be probed, and that the solver gives the same scores with fewer nodes when consulting it.
+*/
+TestResult test_EndgameDatabase() {
+    const char* path = "c4_test_endgame.bin";
+    ASSERT(EndgameDatabase::generate(path, 4, 4));
+
+    EndgameDatabase database;
+    ASSERT(database.open(path));
+    ASSERT(database.rowCount() == 4 && database.columnCount() == 4);
+    ASSERT(database.size() > 0);
+    Solver solver;
+    ASSERT(checkEndgames(database, solver, Position(4, 4), 6));
+    ASSERT(checkEndgames(database, solver, playMoves(4, 4, "2233"), 16));
+
+    // keys survive being taken apart and put back together
+    Position position = playMoves(4, 4, "2214344");
+    ASSERT(Position(4, 4, position.key()).key() == position.key());
+    ASSERT(Position(4, 4, position.key()).moveCount() == position.moveCount());
+    ASSERT(Position(4, 4, position.mirroredKey()).key() == playMoves(4, 4, "3341211").key());
+
+    // mirror images share an entry, while finished games and other sizes aren't held
+    EndgameDatabase::Outcome outcome;
+    EndgameDatabase::Outcome mirroredOutcome;
+    ASSERT(database.probe(playMoves(4, 4, "12"), outcome));
+    ASSERT(database.probe(playMoves(4, 4, "43"), mirroredOutcome));
+    ASSERT(outcome == mirroredOutcome);
+    ASSERT(!database.probe(playMoves(4, 4, "1212121"), outcome));
+    ASSERT(!database.probe(Position(4, 5), outcome));
+
+    // a standard Game of the same size is probed at its current position, anything else isn't
+    Player one("One");
+    Player two("Two");
+    Game game;
+    game.setGrid(new Grid(4, 4));
+    game.setPlayerOne(&one);
+    game.setPlayerTwo(&two);
+    ASSERT(game.playNextTurn(1));
+    ASSERT(game.playNextTurn(1));
+    ASSERT(game.playNextTurn(2));
+    ASSERT(database.probe(game, outcome));
+    ASSERT(database.probe(playMoves(4, 4, "223"), mirroredOutcome));
+    ASSERT(outcome == mirroredOutcome);
+    game.setWinLength(5);
+    ASSERT(!database.probe(game, outcome));
+    SuperGame superGame;
+    superGame.setGrid(new Grid(4, 4));
+    superGame.setPlayerOne(&one);
+    superGame.setPlayerTwo(&two);
+    ASSERT(!database.probe(superGame, outcome));
+
+    // the database narrows the solver's search without changing its scores
+    Solver consulting;
+    consulting.setEndgames(&database);
+    const char* sequences[] = { "", "2", "21", "2233", "112233" };
+    for (unsigned int i = 0; i < 5; ++i) {
+        Position start = playMoves(4, 4, sequences[i]);
+        Solver plain;
+        Solver::Result expected = plain.solve(start);
+        Solver::Result result = consulting.solve(start);
+        ASSERT(result.complete && result.score == expected.score && start.canPlay(result.column));
+        ASSERT(result.nodes <= expected.nodes);
+    }
+    ASSERT(consulting.solve(Position(4, 4)).nodes < Solver().solve(Position(4, 4)).nodes);
+
+    // anything that isn't a database is rejected
+    database.close();
+    ASSERT(!database.isOpen());
+    ASSERT(!database.open("c4_test_missing_endgame.bin"));
+    FILE* file = fopen(path, "wb");
+    ASSERT(file != 0);
+    fputs("not a database at all, but long enough to hold a header", file);
+    fclose(file);
+    ASSERT(!database.open(path));
+    remove(path);
+
+    return TR_PASS;
+}
+
+/*
+Test the Monte Carlo search takes a win and blocks a loss without changing the game, keeps its tree from one move to the
+next, and searches a large SuperGame on several threads.
+*/
+TestResult test_MonteCarlo() {
+    Player one("One");
+    Player two("Two");
+    Game game;
+    game.setGrid(new Grid(6, 7));
+    game.setPlayerOne(&one);
+    game.setPlayerTwo(&two);
+    unsigned int moves[] = { 0, 6, 1, 6, 2 };
+    for (unsigned int i = 0; i < 5; i++) {
+        ASSERT(game.playNextTurn(moves[i]));
+    }
+
+    // player two has to block the bottom row
+    MonteCarlo search;
+    search.setIterationLimit(5000);
+    MonteCarlo::Result result = search.search(game);
+    ASSERT(result.column == 3);
+    ASSERT(result.iterations == 5000);
+    ASSERT(result.reused == 0);
+    ASSERT(game.grid()->discCount() == 5 && game.undoableMoves() == 5);
+    ASSERT(game.status() == Game::GS_IN_PROGRESS);
+
+    // two moves later the tree carries on from where the search left off
+    ASSERT(game.playNextTurn(3));
+    ASSERT(game.playNextTurn(6));
+    result = search.search(game);
+    ASSERT(result.reused > 0);
+    ASSERT(one.getScore() == 0 && two.getScore() == 0);
+
+    // player one wins straight away, rather than blocking player two
+    Game winning;
+    winning.setGrid(new Grid(6, 7));
+    winning.setPlayerOne(&one);
+    winning.setPlayerTwo(&two);
+    unsigned int threat[] = { 0, 6, 1, 6, 2, 6 };
+    for (unsigned int i = 0; i < 6; i++) {
+        ASSERT(winning.playNextTurn(threat[i]));
+    }
+    result = search.search(winning);
+    ASSERT(result.reused == 0);
+    ASSERT(result.column == 3 && result.value > 0.9);
+
+    // a large SuperGame, on threads sharing one tree or growing one each
+    SuperGame super;
+    super.setGrid(new Grid(20, 20));
+    super.setPlayerOne(&one);
+    super.setPlayerTwo(&two);
+    for (unsigned int i = 0; i < 30; i++) {
+        ASSERT(super.playNextTurn((i * 7) % 20));
+    }
+    unsigned int discs = super.grid()->discCount();
+    unsigned int scores[2] = { one.getScore(), two.getScore() };
+    MonteCarlo::Parallelism modes[] = { MonteCarlo::MP_ROOT, MonteCarlo::MP_TREE };
+    for (unsigned int m = 0; m < 2; m++) {
+        MonteCarlo parallel;
+        parallel.setThreads(2);
+        parallel.setParallelism(modes[m]);
+        parallel.setIterationLimit(400);
+        parallel.setRolloutLimit(50);
+        result = parallel.search(super);
+        ASSERT(result.column >= 0 && result.column < 20);
+        ASSERT(result.iterations == 400);
+        ASSERT(result.nodes > 1);
+        ASSERT(super.grid()->discCount() == discs);
+        ASSERT(one.getScore() == scores[0] && two.getScore() == scores[1]);
+    }
+
+    // nothing to search once the game is over
+    ASSERT(winning.playNextTurn(3));
+    ASSERT(winning.status() == Game::GS_COMPLETE);
+    ASSERT(search.search(winning).column == -1);
+
+    return TR_PASS;
+}
+
+/*
+Test random playouts end the way random games do, repeat with the same seed, and have only one outcome once there is a
+single move left, counting the moves of the games they finish.
+*/
+TestResult test_Playout() {
+    // random games on the empty board, where the first player wins a little more than half
+    Playout playout(7);
+    unsigned long long wins[3] = { 0, 0, 0 };
+    playout.playMany(Position(6, 7), 20000, wins);
+    ASSERT(wins[0] + wins[1] + wins[2] == 20000);
+    ASSERT(wins[0] > 10500 && wins[0] < 12500);
+    ASSERT(wins[1] > 7500 && wins[1] < 9500);
+    ASSERT(wins[2] < 400);
+
+    // the same seed plays the same games
+    Position opening = playMoves(6, 7, "4453");
+    Playout first(42);
+    Playout second(99);
+    second.seed(42);
+    for (unsigned int i = 0; i < 100; i++) {
+        ASSERT(first.play(opening) == second.play(opening));
+    }
+
+    // the last cell of the grid either wins for the player to move or leaves a draw
+    Position draw = playMoves(4, 4, "433324221312411");
+    Position win = playMoves(4, 4, "244422314333121");
+    ASSERT(!draw.isWinningMove(3) && win.isWinningMove(0));
+    for (unsigned int i = 0; i < 10; i++) {
+        ASSERT(playout.play(draw) == Grid::GC_EMPTY);
+        ASSERT(playout.moveCount() == 16);
+        ASSERT(playout.play(win) == Grid::GC_PLAYER_TWO);
+        ASSERT(playout.moveCount() == 16);
+    }
+    ASSERT(playout.play(playMoves(4, 4, "4334242213124113")) == Grid::GC_EMPTY);
+    ASSERT(playout.moveCount() == 16);
+
+    // grid sizes switch between the compiled-in strides and the general case
+    unsigned long long tall[3] = { 0, 0, 0 };
+    playout.playMany(Position(10, 5), 2000, tall);
+    ASSERT(tall[0] + tall[1] + tall[2] == 2000);
+    ASSERT(tall[0] > 0 && tall[1] > 0);
+    unsigned long long small[3] = { 0, 0, 0 };
+    playout.playMany(Position(4, 4), 2000, small);
+    ASSERT(small[0] + small[1] + small[2] == 2000);
+    ASSERT(small[2] > 0);
+
+    return TR_PASS;
+}
+
+/*
+Test a batch of games plays exactly like a Game for each of them: random games are replayed on Game objects and must
+end with the same discs, status and winner. Full columns, columns off the grid and finished games are left alone.
+*/
+TestResult test_GameBatch() {
+    GameBatch batch(200, 6, 7);
+    ASSERT(batch.size() == 200 && batch.rowCount() == 6 && batch.columnCount() == 7);
+    ASSERT(batch.inProgress() == 200);
+
+    // play every game to the end at random, recording the moves
+    std::vector<std::vector<unsigned char> > history(batch.size());
+    std::vector<unsigned char> columns(batch.size());
+    uint64_t state = 12345;
+    while (batch.inProgress() > 0) {
+        batch.chooseRandomColumns(&columns[0], state);
+        unsigned int live = batch.inProgress();
+        for (unsigned int i = 0; i < batch.size(); i++) {
+            if (batch.status(i) == Game::GS_IN_PROGRESS) {
+                history[i].push_back(columns[i]);
+            }
+        }
+        ASSERT(batch.step(&columns[0]) == live);
+    }
+
+    Player one("One");
+    Player two("Two");
+    Grid grid(6, 7);
+    unsigned int wins[3] = { 0, 0, 0 };
+    for (unsigned int i = 0; i < batch.size(); i++) {
+        Game game;
+        game.setGrid(new Grid(6, 7));
+        game.setPlayerOne(&one);
+        game.setPlayerTwo(&two);
+        for (unsigned int m = 0; m < history[i].size(); m++) {
+            ASSERT(game.status() == Game::GS_IN_PROGRESS);
+            ASSERT(game.playNextTurn(history[i][m]));
+        }
+        ASSERT(game.status() == Game::GS_COMPLETE);
+        ASSERT(batch.moveCount(i) == history[i].size());
+        ASSERT(batch.copyTo(i, grid));
+        ASSERT(grid.sameDiscs(*game.grid()));
+        Grid::Cell winner = game.winner() == &one ? Grid::GC_PLAYER_ONE
+            : (game.winner() == &two ? Grid::GC_PLAYER_TWO : Grid::GC_EMPTY);
+        // a Game calls a full grid a draw even when the last disc made four
+        ASSERT(batch.winner(i) == winner || (batch.moveCount(i) == 42 && winner == Grid::GC_EMPTY));
+        wins[batch.winner(i)]++;
+    }
+    ASSERT(wins[Grid::GC_PLAYER_ONE] > 0 && wins[Grid::GC_PLAYER_TWO] > 0);
+
+    // finished games ignore their moves until they are restarted
+    ASSERT(batch.step(&columns[0]) == 0);
+    ASSERT(batch.restartFinished() == 200);
+    ASSERT(batch.inProgress() == 200 && batch.moveCount(0) == 0);
+
+    // a full column or one off the grid doesn't play, and doesn't pass the turn
+    GameBatch small(2, 4, 4);
+    unsigned char fill[] = { 0, 1 };
+    for (unsigned int i = 0; i < 4; i++) {
+        fill[1] = (unsigned char)(i % 2 == 0 ? 1 : 2);
+        ASSERT(small.step(fill) == 2);
+    }
+    uint32_t playable[2];
+    small.playableColumns(playable);
+    ASSERT(playable[0] == 0xE && playable[1] == 0xF);
+    unsigned char blocked[] = { 0, 9 };
+    ASSERT(small.step(blocked) == 0);
+    ASSERT(small.moveCount(0) == 4 && small.moveCount(1) == 4);
+    ASSERT(small.bitboard(0, Grid::GC_PLAYER_ONE) == 0x5 && small.bitboard(0, Grid::GC_PLAYER_TWO) == 0xA);
+    ASSERT(small.bitboard(0, Grid::GC_EMPTY) == 0);
+    ASSERT(!small.copyTo(0, grid));
+
+    // Player Two completes column 3 of the second game first, then Player One column 4 of the first
+    unsigned char sequence[] = { 3, 2, 3, 2, 3, 2, 3 };
+    unsigned int played[] = { 2, 2, 2, 2, 1, 1, 1 };
+    for (unsigned int i = 0; i < 7; i++) {
+        unsigned char both[] = { sequence[i], sequence[i] };
+        ASSERT(small.step(both) == played[i]);
+        if (i == 3) {
+            ASSERT(small.status(1) == Game::GS_COMPLETE && small.winner(1) == Grid::GC_PLAYER_TWO);
+            ASSERT(small.status(0) == Game::GS_IN_PROGRESS && small.winner(0) == Grid::GC_EMPTY);
+        }
+    }
+    ASSERT(small.status(0) == Game::GS_COMPLETE && small.winner(0) == Grid::GC_PLAYER_ONE);
+    small.playableColumns(playable);
+    ASSERT(playable[0] == 0 && playable[1] == 0);
+    ASSERT(small.inProgress() == 0);
+    small.restart(1);
+    ASSERT(small.inProgress() == 1 && small.status(0) == Game::GS_COMPLETE);
+
+    return TR_PASS;
+}
+
+/*
+Test a TimeManager has no limits until given some, gives a move time as the hard limit and half of it as the soft one,
+shares a clock out over the moves left, and reports the hard limit once it is reached.
+*/
+TestResult test_TimeManager() {
+    TimeManager clock;
+    clock.start(10);
+    ASSERT(clock.softLimit() == 0 && clock.hardLimit() == 0);
+    ASSERT(!clock.pastSoftLimit() && !clock.pastHardLimit());
+
+    clock.setMoveTime(40);
+    clock.start(10);
+    ASSERT(clock.hardLimit() == 40 && clock.softLimit() == 20);
+
+    // 3000 ms over 10 moves left is 300 ms a move, with up to three times that when needed
+    clock.setClock(3000);
+    clock.start(10);
+    ASSERT(clock.softLimit() == 300 && clock.hardLimit() == 900);
+    // more moves left than the clock is shared between, plus three quarters of the increment
+    clock.setClock(3000, 100);
+    clock.start(100);
+    ASSERT(clock.softLimit() == 175 && clock.hardLimit() == 525);
+    // never more than half of what is left
+    clock.setClock(1000, 0, 1);
+    clock.start(10);
+    ASSERT(clock.softLimit() == 500 && clock.hardLimit() == 500);
+    clock.setClock(0);
+    clock.start(10);
+    ASSERT(clock.hardLimit() == 1);
+
+    clock.setMoveTime(5);
+    clock.start(10);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT(clock.pastSoftLimit() && clock.pastHardLimit());
+    ASSERT(clock.elapsed() >= 10);
+    clock.setMoveTime(0);
+    clock.start(10);
+    ASSERT(!clock.pastHardLimit());
+    return TR_PASS;
+}
+
+/*
+Test iterative deepening takes a win and blocks a loss without changing the game or its players, reports the line and
+depth it searched, stops at a deadline on a grid far too large to search, and plays a SuperGame.
+*/
+TestResult test_IterativeDeepening() {
+    Player one("One");
+    Player two("Two");
+    Game game;
+    game.setGrid(new Grid(6, 7));
+    game.setPlayerOne(&one);
+    game.setPlayerTwo(&two);
+    unsigned int moves[] = { 0, 6, 0, 6, 0 };
+    for (unsigned int i = 0; i < 5; i++) {
+        ASSERT(game.playNextTurn(moves[i]));
+    }
+
+    // player two must block column 0
+    IterativeDeepening search;
+    search.setDepthLimit(4);
+    IterativeDeepening::Result result = search.search(game);
+    ASSERT(result.column == 0);
+    ASSERT(result.depth == 4 && !result.interrupted);
+    ASSERT(!result.line.empty() && result.line[0] == 0);
+    ASSERT(result.nodes > 0);
+    ASSERT(game.grid()->discCount() == 5 && game.nextPlayer() == &two);
+    ASSERT(one.getScore() == 0 && two.getScore() == 0);
+
+    // player one wins in column 0, which no deeper iteration changes
+    ASSERT(game.playNextTurn(6));
+    result = search.search(game);
+    ASSERT(result.column == 0);
+    ASSERT(result.score >= IterativeDeepening::WIN_SCORE - 4);
+    ASSERT(result.depth == 1 && result.line.size() == 1);
+
+    // the same answers with a full window every iteration
+    search.setAspirationWindow(0);
+    ASSERT(search.search(game).column == 0);
+
+    ASSERT(game.playNextTurn(0));
+    ASSERT(game.status() == Game::GS_COMPLETE);
+    ASSERT(search.search(game).column == -1);
+
+    // on a grid far too large to finish even a few plies, the deadline still holds, whether it stops the search part way
+    // through an iteration or before the next one
+    Game large;
+    large.setGrid(new Grid(100, 100));
+    large.setPlayerOne(&one);
+    large.setPlayerTwo(&two);
+    IterativeDeepening timed;
+    timed.setDepthLimit(0);
+    timed.timing().setMoveTime(20);
+    result = timed.search(large);
+    ASSERT(result.depth < IterativeDeepening::MAX_DEPTH);
+    ASSERT(result.column >= 0 && result.column < 100);
+    ASSERT(result.milliseconds < 200);
+    ASSERT(large.grid()->discCount() == 0);
+
+    // a SuperGame, which can't take moves back, keeps its scores
+    SuperGame super;
+    super.setGrid(new Grid(6, 7));
+    super.setPlayerOne(&one);
+    super.setPlayerTwo(&two);
+    unsigned int superMoves[] = { 0, 6, 1, 6, 2 };
+    for (unsigned int i = 0; i < 5; i++) {
+        ASSERT(super.playNextTurn(superMoves[i]));
+    }
+    // player two must block column 3
+    unsigned int scores[2] = { one.getScore(), two.getScore() };
+    result = search.search(super);
+    ASSERT(result.column == 3);
+    ASSERT(super.grid()->discCount() == 5);
+    ASSERT(one.getScore() == scores[0] && two.getScore() == scores[1]);
+    return TR_PASS;
+}
+#endif /*ENABLE_T5_TESTS*/
+
 /*
 This function collects up all the tests as a vector of function pointers. If you create your own
 tests and want to be able to run them, make sure you add them to the `tests` vector here.
@@ -1702,6 +3521,7 @@ vector<TestResult (*)()> generateTests() {
     tests.push_back(&test_PlayerIncreaseScore);
     tests.push_back(&test_PlayerResetScore);
     tests.push_back(&test_PlayerWins);
+    tests.push_back(&test_PlayerDecrease);
 #endif /*ENABLE_T1_TESTS*/
 #ifdef ENABLE_T2_TESTS
     tests.push_back(&test_GridConstruction);
@@ -1711,6 +3531,15 @@ vector<TestResult (*)()> generateTests() {
     tests.push_back(&test_GridInsertDisc);
     tests.push_back(&test_GridInsertFull);
     tests.push_back(&test_GridReset);
+    tests.push_back(&test_GridMultiWord);
+    tests.push_back(&test_GridRemoveDisc);
+    tests.push_back(&test_GridHeights);
+    tests.push_back(&test_GridFallDownMoved);
+    tests.push_back(&test_GridFallDownTall);
+    tests.push_back(&test_GridCopyRowColumn);
+    tests.push_back(&test_GridSparse);
+    tests.push_back(&test_GridHugeIndices);
+    tests.push_back(&test_GridPaddedColumns);
 #endif /*ENABLE_T2_TESTS*/
 #ifdef ENABLE_T3_TESTS
     tests.push_back(&test_GameConstruction);
@@ -1727,6 +3556,10 @@ vector<TestResult (*)()> generateTests() {
     tests.push_back(&test_fig1);
     tests.push_back(&test_DiagDown);
     tests.push_back(&test_DiagUp);
+    tests.push_back(&test_GameWinCheckModes);
+    tests.push_back(&test_GameWinLength);
+    tests.push_back(&test_GameUndoMove);
+    tests.push_back(&test_GameSnapshot);
 #endif /*ENABLE_T3_TESTS*/
 #ifdef ENABLE_T4_TESTS
     tests.push_back(&test_SuperGameMoveSimple);
@@ -1739,7 +3572,30 @@ vector<TestResult (*)()> generateTests() {
     tests.push_back(&test_SuperGameBig);
     tests.push_back(&test_SuperGamePointDraw);
     tests.push_back(&test_SuperGamePlayerSwap);
+    tests.push_back(&test_SuperGameComboSpan);
+    tests.push_back(&test_SuperGameWinLength);
 #endif /*ENABLE_T4_TESTS*/
+#ifdef ENABLE_T5_TESTS
+    tests.push_back(&test_PositionFromGrid);
+    tests.push_back(&test_SolverWinAndBlock);
+    tests.push_back(&test_SolverSmallBoard);
+    tests.push_back(&test_SolverGame);
+    tests.push_back(&test_SolverBudget);
+    tests.push_back(&test_TranspositionTable);
+    tests.push_back(&test_SolverTable);
+    tests.push_back(&test_SolverThreads);
+    tests.push_back(&test_Policies);
+    tests.push_back(&test_Tournament);
+    tests.push_back(&test_BasicGameMatchesGame);
+    tests.push_back(&test_Perft);
+    tests.push_back(&test_OpeningBook);
+    tests.push_back(&test_MonteCarlo);
+    tests.push_back(&test_Playout);
+    tests.push_back(&test_GameBatch);
+    tests.push_back(&test_EndgameDatabase);
+    tests.push_back(&test_TimeManager);
+    tests.push_back(&test_IterativeDeepening);
+#endif /*ENABLE_T5_TESTS*/
 
     return tests;
 }
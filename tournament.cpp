@@ -0,0 +1,98 @@
+// Headless tournament runner. Plays many games between two move-selection policies (see Policy) across a pool of
+// threads and prints each policy's tallies, followed by the throughput of the run.
+//
+// Policies: random, centre, greedy, solver, mcts, deepening.
+//
+// usage: c4_tournament [-a policy] [-b policy] [-g games] [-j threads] [-r rows] [-c columns] [-m game|super]
+//                      [-k win length] [-s seed] [-o opening book]
+#include "ConnectFour/OpeningBook.hpp"
+#include "ConnectFour/Policy.hpp"
+#include "ConnectFour/Tournament.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char const* argv[]){
+	string policyA = "greedy";
+	string policyB = "random";
+	unsigned long long games = 10000;
+	unsigned int threads = 0;
+	unsigned int rows = 6;
+	unsigned int columns = 7;
+	Tournament::Mode mode = Tournament::TM_GAME;
+	unsigned int winLength = 4;
+	unsigned long long seed = 0;
+	string bookFile;
+	for(int i = 1; i + 1 < argc; i += 2){
+		if(strcmp(argv[i], "-a") == 0){
+			policyA = argv[i + 1];
+		} else if(strcmp(argv[i], "-b") == 0){
+			policyB = argv[i + 1];
+		} else if(strcmp(argv[i], "-g") == 0){
+			games = strtoull(argv[i + 1], 0, 10);
+		} else if(strcmp(argv[i], "-j") == 0){
+			threads = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-r") == 0){
+			rows = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-c") == 0){
+			columns = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-m") == 0 && strcmp(argv[i + 1], "game") == 0){
+			mode = Tournament::TM_GAME;
+		} else if(strcmp(argv[i], "-m") == 0 && strcmp(argv[i + 1], "super") == 0){
+			mode = Tournament::TM_SUPERGAME;
+		} else if(strcmp(argv[i], "-k") == 0){
+			winLength = atoi(argv[i + 1]);
+		} else if(strcmp(argv[i], "-s") == 0){
+			seed = strtoull(argv[i + 1], 0, 10);
+		} else if(strcmp(argv[i], "-o") == 0){
+			bookFile = argv[i + 1];
+		} else {
+			cerr << "unknown option " << argv[i] << " " << argv[i + 1] << endl;
+			return 1;
+		}
+	}
+	string names[2] = { policyA, policyB };
+	for(unsigned int i = 0; i < 2; i++){
+		Policy* policy = Policy::create(names[i]);
+		if(policy == 0){
+			cerr << "unknown policy " << names[i] << endl;
+			return 1;
+		}
+		delete policy;
+	}
+
+	OpeningBook book;
+	if(!bookFile.empty() && !book.open(bookFile)){
+		cerr << "can't open book " << bookFile << endl;
+		return 1;
+	}
+
+	Tournament tournament(policyA, policyB);
+	tournament.setGames(games);
+	tournament.setThreads(threads);
+	tournament.setGridSize(rows, columns);
+	tournament.setMode(mode);
+	tournament.setWinLength(winLength);
+	tournament.setSeed(seed);
+	tournament.setBook(book.isOpen() ? &book : 0);
+	Tournament::Result result = tournament.run();
+
+	cout << setw(12) << "policy" << setw(10) << "wins" << setw(10) << "losses" << setw(10) << "draws" << setw(12)
+		 << "score" << endl;
+	for(unsigned int i = 0; i < 2; i++){
+		const Tournament::Tally& tally = result.tallies[i];
+		cout << setw(12) << (names[i] + (i == 0 ? " (A)" : " (B)")) << setw(10) << tally.wins << setw(10)
+			 << tally.losses << setw(10) << tally.draws << setw(12) << tally.score << endl;
+	}
+	double seconds = result.seconds > 0 ? result.seconds : 1e-9;
+	cout << fixed << setprecision(3);
+	cout << result.games << " games, " << result.moves << " moves in " << result.seconds << " s on " << result.threads
+		 << " threads (" << result.steals << " chunks stolen)" << endl;
+	cout << setprecision(1) << result.games / seconds << " games/s, " << result.games / seconds / result.threads
+		 << " games/s per core" << endl;
+	return 0;
+}